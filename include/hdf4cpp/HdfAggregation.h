@@ -0,0 +1,199 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFAGGREGATION_H
+#define HDF4CPP_HDFAGGREGATION_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// Reduces the blocks of an n dimensional row major array to single values.
+/// The array is consumed in row bands (rows are the elements of the first dimension),
+/// so only the reduced output and the accumulators of one output row are held in memory.
+template <class T, class Out> class HdfBlockReducer {
+  public:
+    /// \param aggregation How a block is reduced, see Aggregation
+    /// \param shape The dimensions of the array
+    /// \param block The block size for every dimension, missing dimensions have block size 1
+    HdfBlockReducer(Aggregation aggregation, const std::vector<int32> &shape, std::vector<int32> block)
+        : aggregation(aggregation)
+        , shape(shape)
+        , block(std::move(block)) {
+        this->block.resize(shape.size(), 1);
+        outShape.resize(shape.size());
+        for (size_t i = 0; i < shape.size(); ++i) {
+            outShape[i] = (shape[i] + this->block[i] - 1) / this->block[i];
+        }
+        inStride.assign(shape.size(), 1);
+        outStride.assign(shape.size(), 1);
+        for (size_t i = shape.size(); i-- > 1;) {
+            if (i + 1 < shape.size()) {
+                inStride[i] = inStride[i + 1] * shape[i + 1];
+                outStride[i] = outStride[i + 1] * outShape[i + 1];
+            }
+        }
+        rowSize = shape.size() > 1 ? (size_t)inStride[1] * shape[1] : 1;
+        outRowSize = shape.size() > 1 ? (size_t)outStride[1] * outShape[1] : 1;
+    }
+
+    /// \returns The dimensions of the reduced array
+    const std::vector<int32> &getOutputShape() const {
+        return outShape;
+    }
+
+    /// \returns The number of rows which should be consumed at once, so that
+    /// the band holds about maxElements elements and starts at a block boundary
+    int32 getBandRows(size_t maxElements) const {
+        size_t blockElements = (size_t)block[0] * rowSize;
+        return block[0] * (int32)std::max<size_t>(1, maxElements / std::max<size_t>(1, blockElements));
+    }
+
+    /// Consumes the next rows of the array
+    /// \param data The rows in row major order
+    /// \param rows The number of rows, must be a multiple of the first block size except for the last band
+    /// \param dest The reduced array, it must hold the whole output
+    void consume(const T *data, int32 rows, Out *dest) {
+        for (int32 row = 0; row < rows; ++row) {
+            if (currentRow % block[0] == 0) {
+                reset();
+            }
+            accumulate(1, data + row * rowSize, 0);
+            ++currentRow;
+            if (currentRow % block[0] == 0 || currentRow == shape[0]) {
+                finish(dest + (size_t)((currentRow - 1) / block[0]) * outRowSize);
+            }
+        }
+    }
+
+  private:
+    void reset() {
+        counts.assign(outRowSize, 0);
+        switch (aggregation) {
+        case AGGREGATE_MEAN:
+            sums.assign(outRowSize, 0.0);
+            break;
+        case AGGREGATE_MIN:
+            extremes.assign(outRowSize, std::numeric_limits<T>::max());
+            break;
+        case AGGREGATE_MAX:
+            extremes.assign(outRowSize, std::numeric_limits<T>::lowest());
+            break;
+        case AGGREGATE_MODE:
+            values.assign(outRowSize, std::vector<T>());
+            break;
+        }
+    }
+
+    /// Accumulates the elements of one row, going through the dimensions from the second one
+    void accumulate(size_t dim, const T *in, size_t out) {
+        if (dim >= shape.size()) {
+            reduceRun(in, 1, out);
+        } else if (dim + 1 == shape.size()) {
+            int32 length = shape[dim];
+            int32 size = block[dim];
+            for (int32 i = 0; i < length; i += size) {
+                reduceRun(in + i, std::min(size, length - i), out + i / size);
+            }
+        } else {
+            for (int32 i = 0; i < shape[dim]; ++i) {
+                accumulate(dim + 1, in + (size_t)i * inStride[dim], out + (size_t)(i / block[dim]) * outStride[dim]);
+            }
+        }
+    }
+
+    /// Reduces a contiguous run of elements into one output cell.
+    /// The loops are kept branch free so the compiler can vectorize them.
+    void reduceRun(const T *in, int32 length, size_t cell) {
+        counts[cell] += length;
+        switch (aggregation) {
+        case AGGREGATE_MEAN: {
+            double sum = 0.0;
+            for (int32 i = 0; i < length; ++i) {
+                sum += in[i];
+            }
+            sums[cell] += sum;
+            break;
+        }
+        case AGGREGATE_MIN: {
+            T value = extremes[cell];
+            for (int32 i = 0; i < length; ++i) {
+                value = in[i] < value ? in[i] : value;
+            }
+            extremes[cell] = value;
+            break;
+        }
+        case AGGREGATE_MAX: {
+            T value = extremes[cell];
+            for (int32 i = 0; i < length; ++i) {
+                value = in[i] > value ? in[i] : value;
+            }
+            extremes[cell] = value;
+            break;
+        }
+        case AGGREGATE_MODE:
+            values[cell].insert(values[cell].end(), in, in + length);
+            break;
+        }
+    }
+
+    /// Writes the reduced values of the current output row
+    void finish(Out *dest) {
+        for (size_t i = 0; i < outRowSize; ++i) {
+            switch (aggregation) {
+            case AGGREGATE_MEAN:
+                dest[i] = (Out)(sums[i] / counts[i]);
+                break;
+            case AGGREGATE_MIN:
+            case AGGREGATE_MAX:
+                dest[i] = (Out)extremes[i];
+                break;
+            case AGGREGATE_MODE:
+                dest[i] = (Out)mode(values[i]);
+                break;
+            }
+        }
+    }
+
+    /// \returns The most frequent value, the smallest one if there are more
+    static T mode(std::vector<T> &values) {
+        std::sort(values.begin(), values.end());
+        T best = values.front();
+        size_t bestCount = 0;
+        for (size_t i = 0; i < values.size();) {
+            size_t j = i;
+            while (j < values.size() && values[j] == values[i]) {
+                ++j;
+            }
+            if (j - i > bestCount) {
+                best = values[i];
+                bestCount = j - i;
+            }
+            i = j;
+        }
+        return best;
+    }
+
+    Aggregation aggregation;
+    std::vector<int32> shape;
+    std::vector<int32> block;
+    std::vector<int32> outShape;
+    std::vector<int32> inStride;
+    std::vector<int32> outStride;
+    size_t rowSize;
+    size_t outRowSize;
+    int32 currentRow = 0;
+
+    std::vector<int32> counts;
+    std::vector<double> sums;
+    std::vector<T> extremes;
+    std::vector<std::vector<T>> values;
+};
+}
+
+#endif // HDF4CPP_HDFAGGREGATION_H
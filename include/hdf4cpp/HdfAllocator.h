@@ -0,0 +1,72 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFALLOCATOR_H
+#define HDF4CPP_HDFALLOCATOR_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace hdf4cpp {
+
+namespace detail {
+/// Allocates memory aligned to the given power of two, a large buffer gets the behaviours of the flags
+/// \note Throws std::bad_alloc if the memory cannot be allocated
+void *allocateAligned(size_t bytes, size_t alignment, unsigned flags);
+/// Frees the memory allocated by allocateAligned
+void deallocateAligned(void *pointer);
+}
+
+/// An allocator for the destination vectors of the reads, e.g. std::vector<float32, HdfAllocator<float32>>
+/// (see HdfItem::Buffer), every read which takes a vector takes one with this allocator as well.
+/// The buffers are aligned to Alignment bytes (64 by default, the width of an AVX-512 register),
+/// the large buffers get the behaviours of the Flags (see AllocationFlag).
+/// Resizing the vector does not zero the new values, the reads overwrite them anyway.
+template <class T, size_t Alignment = 64, unsigned Flags = ALLOCATION_HUGE_PAGES> class HdfAllocator {
+    static_assert(Alignment && !(Alignment & (Alignment - 1)), "the alignment must be a power of two");
+
+  public:
+    typedef T value_type;
+
+    template <class U> struct rebind { typedef HdfAllocator<U, Alignment, Flags> other; };
+
+    HdfAllocator() = default;
+    template <class U> HdfAllocator(const HdfAllocator<U, Alignment, Flags> &) {
+    }
+
+    T *allocate(size_t size) {
+        if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        size_t alignment = Alignment < alignof(T) ? alignof(T) : Alignment;
+        return static_cast<T *>(detail::allocateAligned(size * sizeof(T), alignment, Flags));
+    }
+    void deallocate(T *pointer, size_t) {
+        detail::deallocateAligned(pointer);
+    }
+
+    /// Default initializes the value, so the values of a resized vector are not zeroed
+    template <class U> void construct(U *pointer) {
+        ::new ((void *)pointer) U;
+    }
+    template <class U, class... Args> void construct(U *pointer, Args &&... args) {
+        ::new ((void *)pointer) U(std::forward<Args>(args)...);
+    }
+};
+
+template <class T, class U, size_t Alignment, unsigned Flags>
+bool operator==(const HdfAllocator<T, Alignment, Flags> &, const HdfAllocator<U, Alignment, Flags> &) {
+    return true;
+}
+template <class T, class U, size_t Alignment, unsigned Flags>
+bool operator!=(const HdfAllocator<T, Alignment, Flags> &, const HdfAllocator<U, Alignment, Flags> &) {
+    return false;
+}
+}
+
+#endif // HDF4CPP_HDFALLOCATOR_H
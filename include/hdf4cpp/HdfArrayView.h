@@ -0,0 +1,215 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFARRAYVIEW_H
+#define HDF4CPP_HDFARRAYVIEW_H
+
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+#include <hdf4cpp/HdfScratchPool.h>
+#include <hdf4cpp/HdfTypeTraits.h>
+
+#include <vector>
+
+namespace hdf4cpp {
+
+/// A lazy N-dimensional view of the data of an SData item.
+/// The view records which values of the dataset it holds (the start, the strides and the shape)
+/// and the order of its axes. Slicing, striding, selecting an index and transposing make new views
+/// without reading anything, only read gets the values from the file, with one SDreaddata call.
+/// The views are cheap to copy.
+template <class T> class HdfArrayView : public HdfObject {
+  public:
+    /// Views the whole data of an SData item
+    /// \param item the SData item, it must outlive the view and every view made of it
+    explicit HdfArrayView(HdfItem &item)
+        : HdfObject(SDATA, ITEM)
+        , item(&item) {
+        if (item.getType() != SDATA) {
+            raiseException(INVALID_OPERATION);
+        }
+        int32 dataType = item.getDataType();
+        if (!isCompatibleNumberType<T>(dataType)) {
+            raiseException(isReadableNumberType(dataType) ? TYPE_MISMATCH : INVALID_DATA_TYPE);
+        }
+        shape = item.getDims();
+        start.assign(shape.size(), 0);
+        strides.assign(shape.size(), 1);
+        for (size_t i = 0; i < shape.size(); ++i) {
+            axes.push_back(i);
+        }
+    }
+
+    /// \returns the number of values along every axis of the view
+    const std::vector<int32> &getShape() const {
+        return shape;
+    }
+
+    /// \returns the number of axes of the view
+    size_t getRank() const {
+        return shape.size();
+    }
+
+    /// \returns the number of values in the view
+    size_t size() const {
+        size_t size = 1;
+        for (const auto &count : shape) {
+            size *= (size_t)count;
+        }
+        return size;
+    }
+
+    /// \returns the view of a part of an axis, the rank is kept
+    /// \param axis the axis of this view
+    /// \param begin the first index
+    /// \param count the number of indices
+    /// \param stride the difference between the indices, the values in between are skipped
+    HdfArrayView slice(size_t axis, int32 begin, int32 count, int32 stride = 1) const {
+        if (axis >= shape.size() || begin < 0 || count < 0 || stride <= 0 || begin > shape[axis] ||
+            (count && begin + (long long)(count - 1) * stride >= shape[axis])) {
+            raiseException(INVALID_RANGES);
+        }
+        HdfArrayView view(*this);
+        view.start[axes[axis]] += begin * strides[axis];
+        view.strides[axis] *= stride;
+        view.shape[axis] = count;
+        return view;
+    }
+
+    /// \returns the view of one index of an axis, the axis is removed
+    /// \param axis the axis of this view
+    /// \param index the index along the axis
+    HdfArrayView at(size_t axis, int32 index) const {
+        if (axis >= shape.size() || index < 0 || index >= shape[axis]) {
+            raiseException(OUT_OF_RANGE);
+        }
+        HdfArrayView view(*this);
+        view.start[axes[axis]] += index * strides[axis];
+        view.axes.erase(view.axes.begin() + axis);
+        view.strides.erase(view.strides.begin() + axis);
+        view.shape.erase(view.shape.begin() + axis);
+        return view;
+    }
+
+    /// \returns the view with its axes in the given order
+    /// \param order the axes of this view, axis i of the new view is axis order[i] of this view
+    HdfArrayView transpose(const std::vector<size_t> &order) const {
+        if (order.size() != shape.size()) {
+            raiseException(INVALID_RANGES);
+        }
+        std::vector<bool> used(order.size(), false);
+        HdfArrayView view(*this);
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (order[i] >= order.size() || used[order[i]]) {
+                raiseException(INVALID_RANGES);
+            }
+            used[order[i]] = true;
+            view.axes[i] = axes[order[i]];
+            view.strides[i] = strides[order[i]];
+            view.shape[i] = shape[order[i]];
+        }
+        return view;
+    }
+
+    /// \returns the view with its axes in reverse order
+    HdfArrayView transpose() const {
+        std::vector<size_t> order;
+        for (size_t i = shape.size(); i-- > 0;) {
+            order.push_back(i);
+        }
+        return transpose(order);
+    }
+
+    /// Reads the values of the view in row major order
+    /// \param dest the destination vector
+    template <class Alloc> void read(std::vector<T, Alloc> &dest) const {
+        HdfMemoryBudget::Charge charged = charge(size() * sizeof(T));
+        if (!charged) {
+            raiseException(OUT_OF_BUDGET);
+        }
+        dest.resize(size());
+        read(dest.data(), dest.size());
+    }
+
+    /// Reads the values of the view in row major order into a buffer of the caller
+    /// \param dest the destination buffer
+    /// \param capacity the number of values the buffer can hold
+    void read(T *dest, size_t capacity) const {
+        size_t volume = size();
+        if (capacity < volume) {
+            raiseException(BUFFER_SIZE_NOT_ENOUGH);
+        }
+        if (!volume) {
+            return;
+        }
+        // the dataset dimensions which are not axes of the view are read at their start
+        std::vector<int32> slabStride(start.size(), 1);
+        std::vector<int32> edges(start.size(), 1);
+        bool ordered = true;
+        for (size_t i = 0; i < axes.size(); ++i) {
+            slabStride[axes[i]] = strides[i];
+            edges[axes[i]] = shape[i];
+            ordered = ordered && (i == 0 || axes[i - 1] < axes[i]);
+        }
+        HdfItem::HdfDatasetItem *dItem = static_cast<HdfItem::HdfDatasetItem *>(item->item.get());
+        if (ordered) {
+            dItem->readSlab(dest, start, slabStride, edges);
+            return;
+        }
+
+        // the slab is read in the order of the dataset, then its values are reordered to the axes of the view
+        HdfMemoryBudget::Charge charged = charge(volume * sizeof(T));
+        if (!charged) {
+            raiseException(OUT_OF_BUDGET);
+        }
+        HdfScratchPool::Buffer buffer = HdfScratchPool::current().acquire(volume * sizeof(T));
+        dItem->readSlab(buffer.data(), start, slabStride, edges);
+        const T *slab = buffer.as<T>();
+        std::vector<size_t> datasetSteps(start.size(), 1);
+        for (size_t i = start.size() - 1; i > 0; --i) {
+            datasetSteps[i - 1] = datasetSteps[i] * edges[i];
+        }
+        std::vector<size_t> steps;
+        for (const auto &axis : axes) {
+            steps.push_back(datasetSteps[axis]);
+        }
+        size_t rank = shape.size();
+        size_t inner = (size_t)shape[rank - 1];
+        std::vector<int32> index(rank, 0);
+        for (size_t out = 0; out < volume; out += inner) {
+            size_t offset = 0;
+            for (size_t i = 0; i + 1 < rank; ++i) {
+                offset += index[i] * steps[i];
+            }
+            for (size_t j = 0; j < inner; ++j) {
+                dest[out + j] = slab[offset + j * steps[rank - 1]];
+            }
+            for (size_t i = rank - 1; i-- > 0;) {
+                if (++index[i] < shape[i]) {
+                    break;
+                }
+                index[i] = 0;
+            }
+        }
+    }
+
+  private:
+    /// Charges the bytes of a read against the memory budgets of the item, see HdfMemoryBudget
+    HdfMemoryBudget::Charge charge(size_t bytes) const {
+        return HdfMemoryBudget::charge(item->item->getBudget().get(), bytes);
+    }
+
+    HdfItem *item;
+    /// The index of the first value of the view along every dimension of the dataset
+    std::vector<int32> start;
+    /// The dataset dimension of every axis of the view
+    std::vector<size_t> axes;
+    /// The step along the dataset dimension of every axis of the view
+    std::vector<int32> strides;
+    /// The number of values along every axis of the view
+    std::vector<int32> shape;
+};
+}
+
+#endif // HDF4CPP_HDFARRAYVIEW_H
@@ -7,6 +7,7 @@
 #include <hdfi.h>
 #include <hdf4cpp/HdfItem.h>
 #include <hdf4cpp/HdfObject.h>
+#include <hdf4cpp/HdfTypeTraits.h>
 
 namespace hdf4cpp {
 
@@ -35,7 +36,8 @@ class HdfAttribute : public HdfObject {
 
         /// Reads the data from the attribute
         /// \param dest The destination vector
-        virtual void get(void *dest) = 0;
+        /// \returns The error if the data cannot be read
+        virtual HdfStatus get(void *dest) = 0;
 
       protected:
         int32 id;
@@ -54,7 +56,7 @@ class HdfAttribute : public HdfObject {
         int32 _size{};
         int32 dataType{};
 
-        void get(void *dest);
+        HdfStatus get(void *dest);
         int32 getDataType() const;
     };
 
@@ -69,7 +71,7 @@ class HdfAttribute : public HdfObject {
         int32 _size;
         int32 dataType;
 
-        void get(void *dest);
+        HdfStatus get(void *dest);
         int32 getDataType() const;
     };
 
@@ -83,7 +85,21 @@ class HdfAttribute : public HdfObject {
       private:
         int32 _size{};
         int32 dataType{};
-        void get(void *dest);
+        HdfStatus get(void *dest);
+        int32 getDataType() const;
+    };
+
+    /// Attribute class for the GR image attributes
+    class HdfImageAttribute : public HdfAttributeBase {
+      public:
+        HdfImageAttribute(int32 id, const std::string &name, const HdfDestroyerChain &chain);
+
+        int32 size() const;
+
+      private:
+        int32 _size{};
+        int32 dataType{};
+        HdfStatus get(void *dest);
         int32 getDataType() const;
     };
 
@@ -95,36 +111,66 @@ class HdfAttribute : public HdfObject {
     /// \returns the number of elements of the attribute data
     int32 size() const;
 
+    /// \returns the hdf number type of the attribute data (DFNT_*)
+    int32 getDataType() const;
+
     /// Reads the data from the attribute
     /// \param dest the vector in which the data will be stored
-    template <class T> void get(std::vector<T> &dest) {
-        int32 length = size();
-        auto it = typeSizeMap.find(getDataType());
-        if (it != typeSizeMap.end()) {
-            if ((size_t)it->second != sizeof(T)) {
-                raiseException(BUFFER_SIZE_NOT_ENOUGH);
-            }
-            dest.resize(length);
-            getInternal(dest.data());
-        } else {
-            raiseException(INVALID_DATA_TYPE);
+    template <class T, class Alloc> void get(std::vector<T, Alloc> &dest) {
+        tryGet(dest).value();
+    }
+
+    /// Reads the data from the attribute without throwing, see get
+    /// \param dest the vector in which the data will be stored
+    /// \returns the error if the type does not match or the data cannot be read
+    template <class T, class Alloc> HdfStatus tryGet(std::vector<T, Alloc> &dest) {
+        int32 dataType = getDataType();
+        if (!isCompatibleNumberType<T>(dataType)) {
+            return error(isReadableNumberType(dataType) ? TYPE_MISMATCH : INVALID_DATA_TYPE);
+        }
+        HdfMemoryBudget::Charge charged = HdfMemoryBudget::charge(budget.get(), size() * sizeof(T));
+        if (!charged) {
+            return error(OUT_OF_BUDGET);
         }
+        dest.resize(size());
+        return getInternal(dest.data());
     }
 
-    friend HdfAttribute HdfFile::getAttribute(const std::string &name) const;
-    friend HdfAttribute HdfItem::HdfDatasetItem::getAttribute(const std::string &name) const;
-    friend HdfAttribute HdfItem::HdfGroupItem::getAttribute(const std::string &name) const;
-    friend HdfAttribute HdfItem::HdfDataItem::getAttribute(const std::string &name) const;
+    friend HdfResult<HdfAttribute> HdfFile::tryGetAttribute(const std::string &name) const;
+    friend HdfResult<HdfAttribute> HdfItem::HdfDatasetItem::tryGetAttribute(const std::string &name) const;
+    friend HdfResult<HdfAttribute> HdfItem::HdfGroupItem::tryGetAttribute(const std::string &name) const;
+    friend HdfResult<HdfAttribute> HdfItem::HdfDataItem::tryGetAttribute(const std::string &name) const;
+    friend HdfResult<HdfAttribute> HdfItem::HdfImageItem::tryGetAttribute(const std::string &name) const;
 
   private:
     HdfAttribute(HdfAttributeBase *attribute);
 
+    /// \returns the index of the attribute with the given name, FAIL if there is none
+    /// \param id the id of the file or the item
+    /// \param type the type of the item, SDATA for the file
+    /// \param name the name of the attribute
+    static int32 findIndex(int32 id, Type type, const std::string &name);
+
+    /// \returns the attribute with the given name, the error of the missing attribute is returned without throwing
+    /// \param id the id of the file or the item
+    /// \param type the type of the item, SDATA for the file
+    /// \param name the name of the attribute
+    /// \param chain the destroyer chain of the file or the item
+    /// \param budget the memory budget of the file, see HdfMemoryBudget
+    static HdfResult<HdfAttribute> tryOpen(int32 id,
+                                           Type type,
+                                           const std::string &name,
+                                           const HdfDestroyerChain &chain,
+                                           const std::shared_ptr<HdfMemoryBudget> &budget);
+
     /// An internal get function
     /// \param dest The destination buffer
-    void getInternal(void *dest);
-    int32 getDataType() const;
+    /// \returns The error if the data cannot be read
+    HdfStatus getInternal(void *dest);
     /// Holds an attribute object address
     std::unique_ptr<HdfAttributeBase> attribute;
+    /// The memory budget of the file which the reads charge
+    std::shared_ptr<HdfMemoryBudget> budget;
 };
 }
 
@@ -0,0 +1,125 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFBATCH_H
+#define HDF4CPP_HDFBATCH_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// A rectangular region of an n dimensional array without stride:
+/// [begin, begin + count) in every dimension
+struct HdfBox {
+    std::vector<int32> begin;
+    std::vector<int32> count;
+
+    /// \returns The number of elements in the box
+    size_t volume() const {
+        size_t volume = 1;
+        for (const auto &c : count) {
+            volume *= c;
+        }
+        return volume;
+    }
+
+    /// \returns The smallest box which contains both boxes
+    HdfBox unite(const HdfBox &other) const {
+        HdfBox box;
+        for (size_t i = 0; i < begin.size(); ++i) {
+            int32 first = std::min(begin[i], other.begin[i]);
+            int32 last = std::max(begin[i] + count[i], other.begin[i] + other.count[i]);
+            box.begin.push_back(first);
+            box.count.push_back(last - first);
+        }
+        return box;
+    }
+};
+
+/// The reads which serve a batch of requests
+struct HdfReadPlan {
+    /// The boxes which have to be read, in row major order of their begin
+    std::vector<HdfBox> reads;
+    /// For every request the index of the read containing it
+    std::vector<size_t> readOf;
+};
+
+/// Merges the requested boxes into a minimal set of reads.
+/// Two groups of requests are merged if the volume of the box containing both is at most maxWaste times
+/// the sum of their requested volumes (overlapping parts are counted for every request).
+/// Whether overlapping or adjacent requests are merged depends only on this rule: with maxWaste >= 1
+/// adjacent boxes of the same extent are merged, but thin boxes which cross each other (e.g. a row and
+/// a column) span a much larger box and are not merged.
+/// \param requests The requested boxes, all of them must have the same rank
+/// \param maxWaste The tolerated ratio between the read and the requested volume
+HdfReadPlan planCoalescedReads(const std::vector<HdfBox> &requests, float64 maxWaste = 2.0);
+
+namespace detail {
+/// Calls the function for every contiguous row of the inner box with
+/// the offset of the row in the outer box, the offset in the inner box and the length of the row
+template <class Function> void forEachBoxRow(const HdfBox &outer, const HdfBox &inner, Function &&function) {
+    size_t rank = outer.count.size();
+    if (!rank || !inner.volume()) {
+        return;
+    }
+    std::vector<size_t> strides(rank, 1);
+    for (size_t i = rank - 1; i > 0; --i) {
+        strides[i - 1] = strides[i] * outer.count[i];
+    }
+    // odometer over the inner box without its last dimension, a contiguous row at a time
+    std::vector<int32> index(rank, 0);
+    size_t row = (size_t)inner.count[rank - 1];
+    size_t innerOffset = 0;
+    while (true) {
+        size_t offset = 0;
+        for (size_t i = 0; i < rank; ++i) {
+            offset += (size_t)(inner.begin[i] - outer.begin[i] + index[i]) * strides[i];
+        }
+        function(offset, innerOffset, row);
+        innerOffset += row;
+        if (rank == 1) {
+            return;
+        }
+        size_t dim = rank - 1;
+        while (true) {
+            --dim;
+            if (++index[dim] < inner.count[dim]) {
+                break;
+            }
+            index[dim] = 0;
+            if (dim == 0) {
+                return;
+            }
+        }
+    }
+}
+}
+
+/// Copies a box out of a larger box which contains it
+/// \param source The data of the outer box in row major order
+/// \param outer The outer box
+/// \param dest The destination of the inner box in row major order
+/// \param inner The inner box
+template <class T> void copyBox(const T *source, const HdfBox &outer, T *dest, const HdfBox &inner) {
+    detail::forEachBoxRow(outer, inner, [&](size_t outerOffset, size_t innerOffset, size_t length) {
+        std::copy(source + outerOffset, source + outerOffset + length, dest + innerOffset);
+    });
+}
+
+/// Copies a box into a larger box which contains it, the inverse of copyBox
+/// \param source The data of the inner box in row major order
+/// \param inner The inner box
+/// \param dest The data of the outer box in row major order
+/// \param outer The outer box
+template <class T> void pasteBox(const T *source, const HdfBox &inner, T *dest, const HdfBox &outer) {
+    detail::forEachBoxRow(outer, inner, [&](size_t outerOffset, size_t innerOffset, size_t length) {
+        std::copy(source + innerOffset, source + innerOffset + length, dest + outerOffset);
+    });
+}
+}
+
+#endif // HDF4CPP_HDFBATCH_H
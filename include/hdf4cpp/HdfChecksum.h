@@ -0,0 +1,100 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFCHECKSUM_H
+#define HDF4CPP_HDFCHECKSUM_H
+
+#include <hdf4cpp/HdfDefines.h>
+#include <hdf4cpp/HdfFile.h>
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+#include <hdf4cpp/HdfThreadPool.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// The 64 bit xxHash (XXH64) of a byte sequence, computed incrementally
+class HdfHash64 {
+  public:
+    explicit HdfHash64(std::uint64_t seed = 0);
+
+    /// Hashes the next bytes of the sequence
+    void update(const void *data, size_t size);
+    /// \returns The hash of the bytes given so far, more bytes can be given afterwards
+    std::uint64_t digest() const;
+
+  private:
+    std::uint64_t seed;
+    std::uint64_t accumulators[4];
+    /// The bytes which do not fill a stripe of 32 bytes yet
+    uint8 buffer[32];
+    size_t buffered = 0;
+    std::uint64_t length = 0;
+};
+
+/// Settings of the checksum computation
+struct HdfChecksumOptions {
+    /// The maximum size of a band of SData or a batch of VData records read at once in bytes
+    /// (at least one row or record is read)
+    size_t bandSize = STREAM_BUFFER_SIZE;
+    /// The seed of the hash
+    std::uint64_t seed = 0;
+};
+
+/// The checksum of the content of an item
+struct HdfChecksum {
+    /// The path of the item (see HdfItem::getPath)
+    std::string path;
+    /// The type of the item, SDATA or VDATA
+    Type type;
+    /// The number of data bytes which were hashed
+    std::uint64_t size;
+    /// The hash of the shape and the data of the item
+    std::uint64_t digest;
+};
+
+/// The checksums of the SData and VData items of a file
+struct HdfChecksumManifest {
+    /// The checksums of the items, sorted by path
+    std::vector<HdfChecksum> items;
+    /// The hash of the paths and the digests of the items, it does not depend on the order of the items in the file
+    std::uint64_t digest = 0;
+
+    /// \returns The text form of the manifest: a line with the digest, the type, the size and the path
+    /// of every item, then a line with the digest of the file
+    std::string toString() const;
+};
+
+/// Computes checksums of the content of SData and VData items, the storage (chunking, compression,
+/// interlace, byte order in the file) does not change them.
+/// The data is read in bands (SData, see HdfItem::readAnyBands) or record batches (VData, see
+/// HdfItem::readRecordBatches) on the calling thread, while the previous band is hashed by a worker thread.
+/// Besides the data, the number type and the dimensions (SData) or the record count, the record size and
+/// the name, number type and order of every field (VData) are hashed.
+/// The values are hashed in the byte order of the machine.
+class HdfChecksummer : public HdfObject {
+  public:
+    explicit HdfChecksummer(const HdfChecksumOptions &options = HdfChecksumOptions());
+    HdfChecksummer(const HdfChecksummer &) = delete;
+    HdfChecksummer &operator=(const HdfChecksummer &) = delete;
+
+    /// \returns The checksum of an SData or VData item
+    HdfChecksum checksum(HdfItem &item);
+
+    /// \returns The checksums of every SData and VData item of the file
+    HdfChecksumManifest checksumFile(const HdfFile &file);
+
+  private:
+    struct BandHasher;
+
+    HdfChecksumOptions options;
+    HdfThreadPool pool;
+    HdfTaskWindow window;
+};
+}
+
+#endif // HDF4CPP_HDFCHECKSUM_H
@@ -16,6 +16,21 @@
 
 #define MAX_DIMENSION 32
 #define MAX_NAME_LENGTH 1000
+/// The length of the longest field list of a VData (256 fields with names of 128 characters, separated by commas)
+#define MAX_FIELD_LIST_LENGTH 33024
+/// The number of elements held in memory at once by the streaming reads
+#define STREAM_BUFFER_SIZE 1048576
+/// The largest number of bytes kept by a scratch pool for reuse, see HdfScratchPool
+#ifndef SCRATCH_POOL_SIZE
+#define SCRATCH_POOL_SIZE 67108864
+#endif
+/// The smallest buffer in bytes which is large for HdfAllocator (the size of a huge page on x86-64)
+#define LARGE_BUFFER_SIZE 2097152
+/// The largest number of bytes read by one SDreaddata call, larger reads are split into more calls
+/// (HDF4 computes the byte count of a request in int32)
+#ifndef MAX_READ_SIZE
+#define MAX_READ_SIZE 1073741824
+#endif
 
 namespace hdf4cpp {
 /// \enum Type
@@ -28,7 +43,9 @@ namespace hdf4cpp {
 /// VGroup type
 /// \var VDATA
 /// VData type
-enum Type { HFILE, SDATA, VGROUP, VDATA };
+/// \var GRIMAGE
+/// GR (general raster) image type
+enum Type { HFILE, SDATA, VGROUP, VDATA, GRIMAGE };
 
 /// \enum ClassType
 /// What kind of object it represents:
@@ -40,7 +57,43 @@ enum Type { HFILE, SDATA, VGROUP, VDATA };
 /// attribute
 /// \var ITERATOR
 /// iterator
-enum ClassType { FILE, ITEM, ATTRIBUTE, ITERATOR };
+/// \var DIMENSION
+/// dimension
+enum ClassType { FILE, ITEM, ATTRIBUTE, ITERATOR, DIMENSION };
+
+/// \enum Aggregation
+/// How a block of data is reduced to one value by the aggregating reads
+/// \var AGGREGATE_MEAN
+/// arithmetic mean of the block
+/// \var AGGREGATE_MIN
+/// smallest value of the block
+/// \var AGGREGATE_MAX
+/// largest value of the block
+/// \var AGGREGATE_MODE
+/// most frequent value of the block
+enum Aggregation { AGGREGATE_MEAN, AGGREGATE_MIN, AGGREGATE_MAX, AGGREGATE_MODE };
+
+/// \enum Interlace
+/// The order of the components of a multi-component (e.g. RGB) GR image in a buffer
+/// \var INTERLACE_PIXEL
+/// the components of a pixel are adjacent: [row][column][component]
+/// \var INTERLACE_LINE
+/// every row holds its lines one component after the other: [row][component][column]
+/// \var INTERLACE_COMPONENT
+/// planar, every component is a whole image: [component][row][column]
+enum Interlace { INTERLACE_PIXEL, INTERLACE_LINE, INTERLACE_COMPONENT };
+
+/// \enum AllocationFlag
+/// Optional behaviours of HdfAllocator for the large buffers (see LARGE_BUFFER_SIZE), they can be combined with |
+/// \var ALLOCATION_HUGE_PAGES
+/// the buffer is backed by transparent huge pages (madvise(MADV_HUGEPAGE), only on Linux), so it needs fewer TLB entries
+/// \var ALLOCATION_FIRST_TOUCH
+/// the buffer is split into contiguous parts and every part is zeroed by a thread of a shared pool
+/// (one thread per hardware thread), so unlike the other buffers it is zeroed when allocated.
+/// The threads are not pinned, so on NUMA systems the pages land on the nodes where the threads happen to run:
+/// they are usually spread over the nodes instead of the node of the allocating thread,
+/// but they are not placed next to the threads which read or process them later
+enum AllocationFlag { ALLOCATION_HUGE_PAGES = 1, ALLOCATION_FIRST_TOUCH = 2 };
 
 /// \enum ExceptionType The type of the HdfException
 enum ExceptionType {
@@ -53,6 +106,10 @@ enum ExceptionType {
     INVALID_RANGES,
     STATUS_RETURN_FAIL,
     INVALID_DATA_TYPE,
+    TYPE_MISMATCH,
+    WRITE_FAIL,
+    READ_FAIL,
+    OUT_OF_BUDGET,
     OTHER
 };
 
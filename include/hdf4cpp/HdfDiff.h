@@ -0,0 +1,104 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFDIFF_H
+#define HDF4CPP_HDFDIFF_H
+
+#include <hdf4cpp/HdfDefines.h>
+#include <hdf4cpp/HdfFile.h>
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// Settings of the comparison
+struct HdfDiffOptions {
+    /// The largest absolute difference of two SData values which are still equal, 0 compares exactly
+    float64 tolerance = 0.0;
+    /// The largest difference of two SData values relative to the larger magnitude which are still equal
+    float64 relativeTolerance = 0.0;
+    /// Stops at the first difference, then the statistics of the result are incomplete
+    bool stopAtFirst = false;
+    /// Compares the attributes of the items
+    bool compareAttributes = true;
+    /// The maximum size of a band of SData or a batch of VData records read at once from a file in bytes
+    /// (at least one row or record is read)
+    size_t bandSize = STREAM_BUFFER_SIZE;
+};
+
+/// The differences of two matched items
+struct HdfItemDiff {
+    /// The path of the items (see HdfItem::getPath)
+    std::string path;
+    /// The type of the items
+    Type type;
+    /// The differences of the metadata and the attributes, one description for each
+    std::vector<std::string> differences;
+    /// The number of compared values (SData) or records (VData)
+    std::uint64_t compared = 0;
+    /// The number of differing values (SData) or records (VData)
+    std::uint64_t differing = 0;
+    /// The largest absolute difference of the compared SData values, the ones within the tolerances included
+    /// (NaN if only one of two values is NaN)
+    float64 maxAbsDiff = 0.0;
+    /// The index of the first differing value or record in row major order, valid if differing is not 0
+    std::uint64_t firstDifference = 0;
+
+    /// \returns true if nothing differs
+    bool equal() const {
+        return differences.empty() && !differing;
+    }
+};
+
+/// The differences of two files
+struct HdfFileDiff {
+    /// The paths of the items which are only in the first file
+    std::vector<std::string> onlyInFirst;
+    /// The paths of the items which are only in the second file
+    std::vector<std::string> onlyInSecond;
+    /// The items which are in both files and differ
+    std::vector<HdfItemDiff> items;
+    /// The number of compared item pairs
+    size_t compared = 0;
+
+    /// \returns true if nothing differs
+    bool equal() const {
+        return onlyInFirst.empty() && onlyInSecond.empty() && items.empty();
+    }
+
+    /// \returns The readable report of the differences, one line for each
+    std::string toString() const;
+};
+
+/// Compares the structure, the attributes and the data of items or files.
+/// The items of two files are matched by their type and path, the items with the same path are matched in the
+/// order of the files. SData values are compared in bands (see HdfDiffOptions::bandSize) with the tolerances,
+/// VData records are compared byte by byte in record batches, so at most two bands are held in memory.
+/// GR images and VGroups are compared by their metadata and attributes.
+class HdfDiffer : public HdfObject {
+  public:
+    explicit HdfDiffer(const HdfDiffOptions &options = HdfDiffOptions());
+
+    /// \returns The differences of two items of the same type
+    HdfItemDiff diff(HdfItem &first, HdfItem &second) const;
+
+    /// \returns The differences of two files
+    HdfFileDiff diff(const HdfFile &first, const HdfFile &second) const;
+
+  private:
+    struct BandComparer;
+
+    void compareAttributes(const HdfItem &first, const HdfItem &second, std::vector<std::string> &differences) const;
+    void compareDatasets(HdfItem &first, HdfItem &second, HdfItemDiff &result) const;
+    void compareRecords(HdfItem &first, HdfItem &second, HdfItemDiff &result) const;
+
+    HdfDiffOptions options;
+};
+}
+
+#endif // HDF4CPP_HDFDIFF_H
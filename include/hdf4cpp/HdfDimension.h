@@ -0,0 +1,135 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFDIMENSION_H
+#define HDF4CPP_HDFDIMENSION_H
+
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+#include <hdf4cpp/HdfTypeTraits.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// Finds the indices of coordinate values in intervals.
+/// Monotonic (increasing or decreasing) coordinates are binary searched,
+/// for the other ones a sorted index and a sparse table of the smallest and largest indices of its blocks
+/// are built once, so every query costs log(n) plus the scan of at most two blocks.
+class HdfCoordinateIndex {
+  public:
+    explicit HdfCoordinateIndex(std::vector<float64> values);
+
+    /// \returns the range of the indices whose values are in the interval,
+    /// for not monotonic values the smallest range which holds every matching index
+    /// \note The range is empty (its quantity is 0) if no value is in the interval
+    Range find(const HdfInterval &interval) const;
+
+    /// \returns true if the values are increasing or decreasing
+    bool isMonotonic() const;
+
+  private:
+    enum Order { INCREASING, DECREASING, UNORDERED };
+
+    /// The number of consecutive entries of the sorted index in a block of the sparse table
+    static const size_t BLOCK_SIZE = 64;
+
+    /// \returns The smallest and the largest index in the entries [first, last) of the sorted index
+    std::pair<int32, int32> getBounds(size_t first, size_t last) const;
+
+    std::vector<float64> values;
+    Order order;
+    /// The indices of the values in increasing order of the values (NaNs last), only for unordered values
+    std::vector<int32> sorted;
+    /// The number of values which are not NaN
+    size_t valid;
+    /// The smallest and the largest index of every 2^level consecutive blocks of the sorted index, by level
+    std::vector<std::vector<std::pair<int32, int32>>> blockBounds;
+};
+
+/// A dimension of an SData item.
+/// The dimensions with the same name are shared by the datasets of a file,
+/// their scale is read from the file only once and cached until the file is closed.
+/// An unlimited dimension has the current size of the dataset, so its scale is shared
+/// only by the datasets of the same size.
+class HdfDimension : public HdfObject {
+  public:
+    /// \returns the name of the dimension
+    const std::string &getName() const;
+
+    /// \returns the current size of the dimension
+    int32 getSize() const;
+
+    /// \returns true if the dimension is unlimited
+    bool isUnlimited() const;
+
+    /// \returns true if a scale (coordinate values) is set for the dimension
+    bool hasScale() const;
+
+    /// \returns the hdf number type of the scale, 0 if there is no scale
+    int32 getDataType() const;
+
+    /// \returns the index of the scale values, it is built by the first call for the dimension
+    /// \note The dimension must have a scale
+    const HdfCoordinateIndex &getCoordinateIndex() const;
+
+    /// Reads the scale of the dimension, one value for every index of the dimension
+    /// \param dest the destination vector
+    template <class T, class Alloc> void getScale(std::vector<T, Alloc> &dest) const {
+        if (!hasScale()) {
+            raiseException(INVALID_OPERATION);
+        }
+        if (!isCompatibleNumberType<T>(dataType)) {
+            raiseException(isReadableNumberType(dataType) ? TYPE_MISMATCH : INVALID_DATA_TYPE);
+        }
+        const std::vector<uint8> &data = loadScale();
+        const T *values = reinterpret_cast<const T *>(data.data());
+        dest.assign(values, values + data.size() / sizeof(T));
+    }
+
+    /// The cached scale of a shared dimension
+    struct Scale;
+
+    friend class HdfItem;
+
+  private:
+    HdfDimension(int32 sId,
+                 int32 id,
+                 const std::string &name,
+                 int32 size,
+                 bool unlimited,
+                 int32 dataType,
+                 const std::shared_ptr<Scale> &scale,
+                 const HdfDestroyerChain &chain);
+
+    /// \returns the bytes of the scale, they are read from the file by the first call for the dimension
+    const std::vector<uint8> &loadScale() const;
+    /// loadScale without locking, the mutex of the scale must be held
+    const std::vector<uint8> &readScale() const;
+    /// \returns the number of values SDgetdimscale writes: the record count of the coordinate variable
+    /// for an unlimited dimension (it may exceed the size in the dataset), otherwise the size
+    int32 getStoredScaleSize() const;
+
+    /// \returns the cached scale of a dimension, shared by the datasets of the file
+    /// \param sId the id of the file opened with SDstart
+    /// \param token the token of the destroyer chain of the file
+    /// \param name the name of the dimension
+    /// \param size the size of the dimension in the dataset
+    static std::shared_ptr<Scale>
+    getSharedScale(int32 sId, const std::weak_ptr<const void> &token, const std::string &name, int32 size);
+
+    int32 sId;
+    int32 id;
+    std::string name;
+    int32 size;
+    bool unlimited;
+    int32 dataType;
+    std::shared_ptr<Scale> scale;
+};
+}
+
+#endif // HDF4CPP_HDFDIMENSION_H
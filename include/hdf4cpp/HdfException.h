@@ -7,6 +7,8 @@
 
 #include <hdf4cpp/HdfDefines.h>
 
+#include <string>
+
 namespace hdf4cpp {
 
 class HdfException : public std::exception {
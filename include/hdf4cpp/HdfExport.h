@@ -0,0 +1,98 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFEXPORT_H
+#define HDF4CPP_HDFEXPORT_H
+
+#include <hdf4cpp/HdfDefines.h>
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+#include <hdf4cpp/HdfThreadPool.h>
+
+#include <ios>
+#include <string>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// \enum ExportFormat The output format of HdfExporter
+enum ExportFormat {
+    /// numpy .npy file: a header with the dtype and the shape followed by the data in C order
+    EXPORT_NPY,
+    /// raw binary data in C order, described by a JSON file next to it (<path>.json)
+    EXPORT_RAW
+};
+
+/// Settings of the export
+struct HdfExportOptions {
+    /// The format of the output files
+    ExportFormat format = EXPORT_NPY;
+    /// The maximum size of a band read at once in bytes (at least one row is read)
+    size_t bandSize = STREAM_BUFFER_SIZE;
+    /// The number of writer threads, 0 means one per hardware thread
+    size_t threads = 0;
+    /// The maximum number of bands held in memory, 0 means one more than the number of writers
+    size_t maxPendingBands = 0;
+};
+
+/// One dataset to export in a batch
+struct HdfExportJob {
+    /// The path of the hdf file
+    std::string file;
+    /// The name of the SData item
+    std::string item;
+    /// The path of the output file
+    std::string output;
+    /// The region to export, empty means the whole data
+    std::vector<Range> ranges;
+};
+
+/// \returns The numpy dtype string of an hdf number type in the byte order of the machine (e.g. "<f4")
+/// \param dataType the hdf number type (DFNT_*)
+/// \returns an empty string if the number type is not readable
+std::string npyDescr(int32 dataType);
+
+/// \returns The header of a version 1.0 .npy file, padded to a multiple of 64 bytes
+/// \param dataType the hdf number type of the data
+/// \param shape the dimensions of the data
+std::string npyHeader(int32 dataType, const std::vector<int32> &shape);
+
+/// Streams SData items to .npy or raw binary files.
+/// The data is read band by band on the calling thread (the hdf library is not thread safe),
+/// while the previous bands are written by worker threads, every band to its own offset.
+/// At most maxPendingBands bands are held in memory, also when many datasets are exported.
+class HdfExporter : public HdfObject {
+  public:
+    explicit HdfExporter(const HdfExportOptions &options = HdfExportOptions());
+    HdfExporter(const HdfExporter &) = delete;
+    HdfExporter &operator=(const HdfExporter &) = delete;
+
+    /// Exports an SData item
+    /// \param item the SData item
+    /// \param path the path of the output file, it is overwritten
+    /// \param ranges the region to export (see Range), missing ranges cover the whole dimension
+    /// \note Returns when the last band is queued, wait() has to be called before using the output
+    void exportDataset(HdfItem &item, const std::string &path, std::vector<Range> ranges = std::vector<Range>());
+
+    /// Exports many datasets, the consecutive jobs of the same file share the opened file
+    /// \param jobs the datasets to export
+    /// \note Returns when every output is written
+    void exportDatasets(const std::vector<HdfExportJob> &jobs);
+
+    /// Waits until every queued band is written
+    /// \note Rethrows the first error of the writers
+    void wait();
+
+  private:
+    struct BandWriter;
+
+    void writeAt(const std::string &path, std::streamoff offset, const char *data, size_t size) const;
+
+    HdfExportOptions options;
+    HdfThreadPool pool;
+    HdfTaskWindow window;
+};
+}
+
+#endif // HDF4CPP_HDFEXPORT_H
@@ -8,11 +8,13 @@
 #include <string>
 #include <vector>
 
+#include <hdf4cpp/HdfMemoryBudget.h>
 #include <hdf4cpp/HdfObject.h>
 
 namespace hdf4cpp {
 
 class HdfItem;
+class HdfItemRef;
 class HdfAttribute;
 
 /// Opens an hdf file and provides operations with it
@@ -27,12 +29,19 @@ class HdfFile : public HdfObject {
 
     int32 getSId() const;
     int32 getVId() const;
+    /// \returns the id of the GR interface, FAIL if it could not be started
+    int32 getGRId() const;
 
     /// \returns an item from the file with the given name
     /// \param name the name of the item
     /// \note: If there are multiple items with the same name then the first will be returned
     HdfItem get(const std::string &name) const;
 
+    /// \returns an item from the file with the given name, or the error if there is none.
+    /// Nothing is thrown for a missing item, so it is cheap to probe for optional items.
+    /// \param name the name of the item
+    HdfResult<HdfItem> tryGet(const std::string &name) const;
+
     /// \returns all the items from the file with the given name
     /// \param name the name of the item(s)
     std::vector<HdfItem> getAll(const std::string &name) const;
@@ -41,23 +50,48 @@ class HdfFile : public HdfObject {
     /// \param name the name of the attribute
     HdfAttribute getAttribute(const std::string &name) const;
 
+    /// \returns the attribute with the given name, or the error if there is none, without throwing
+    /// \param name the name of the attribute
+    HdfResult<HdfAttribute> tryGetAttribute(const std::string &name) const;
+
+    /// \returns the memory budget of the file, the reads of its items and attributes charge it
+    /// besides the budget of the process, see HdfMemoryBudget
+    HdfMemoryBudget &getMemoryBudget() const;
+
     class Iterator;
 
     Iterator begin() const;
     Iterator end() const;
 
+    /// \returns references to the items which are not members of any VGroup,
+    /// in the order of the iterator, without attaching to them
+    /// \note The lone GR images are looked up by the first call of this or of the iterator, not by the constructor
+    std::vector<HdfItemRef> getRefs() const;
+
+    friend class HdfHierarchy;
+
   private:
     int32 getDatasetId(const std::string &name) const;
     int32 getGroupId(const std::string &name) const;
     int32 getDataId(const std::string &name) const;
+    int32 getImageId(const std::string &name) const;
 
     std::vector<int32> getDatasetIds(const std::string &name) const;
     std::vector<int32> getGroupDataIds(const std::string &name) const;
+    std::vector<int32> getImageIds(const std::string &name) const;
+
+    /// \returns The lone VGroups and VData, then the lone GR images, which are listed by the first call
+    const std::vector<std::pair<int32, Type>> &getLoneRefs() const;
 
     int32 sId;
     int32 vId;
+    int32 grId;
+    /// The memory budget of the file, it is resolved once and shared by the items
+    std::shared_ptr<HdfMemoryBudget> budget;
 
-    std::vector<std::pair<int32, Type>> loneRefs;
+    /// The items which are not members of any VGroup, the GR images are appended by getLoneRefs
+    mutable std::vector<std::pair<int32, Type>> loneRefs;
+    mutable bool loneImagesListed = false;
 };
 
 /// HdfFile iterator, gives the possibility to iterate over the items in the file
@@ -0,0 +1,58 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFFILELOCAL_H
+#define HDF4CPP_HDFFILELOCAL_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace hdf4cpp {
+
+/// Holds one object per open file, e.g. a cache shared by all the items of the file.
+/// The objects are keyed by the file id and the token of the destroyer chain of the file
+/// (see HdfDestroyerChain::getToken), so an object is dropped when its file is closed,
+/// even if the id is reused by an other file.
+template <class T> class HdfFileLocal {
+  public:
+    /// \returns the object of the file, it is created by the first call
+    /// \param fileId the id of the file
+    /// \param token the token of the destroyer chain of the file
+    /// \param create called without arguments to create the object, returns std::shared_ptr<T>
+    template <class Create>
+    std::shared_ptr<T> get(int32 fileId, const std::weak_ptr<const void> &token, Create &&create) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.token.expired()) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        auto it = entries.find(fileId);
+        if (it != entries.end() && !it->second.token.owner_before(token) && !token.owner_before(it->second.token)) {
+            return it->second.value;
+        }
+        std::shared_ptr<T> value = create();
+        if (!token.expired()) {
+            entries[fileId] = Entry{token, value};
+        }
+        return value;
+    }
+
+  private:
+    struct Entry {
+        std::weak_ptr<const void> token;
+        std::shared_ptr<T> value;
+    };
+
+    std::mutex mutex;
+    std::map<int32, Entry> entries;
+};
+}
+
+#endif // HDF4CPP_HDFFILELOCAL_H
@@ -0,0 +1,153 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFGENERATOR_H
+#define HDF4CPP_HDFGENERATOR_H
+
+// The coroutine generators need C++20, they are compiled only in the HDF4CPP_COROUTINES build mode.
+// HdfTileSequence and HdfRecordSequence provide the same lazy sequences in C++11.
+#if defined(HDF4CPP_COROUTINES) && defined(__cpp_impl_coroutine)
+
+#include <hdf4cpp/HdfItem.h>
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <utility>
+
+namespace hdf4cpp {
+
+/// A lazy sequence produced by a coroutine, the coroutine runs until the next co_yield on every increment.
+/// The yielded values are referenced, not copied, they are valid until the next increment.
+template <class T> class HdfGenerator {
+  public:
+    struct promise_type {
+        T *value = nullptr;
+        std::exception_ptr error;
+
+        HdfGenerator get_return_object() {
+            return HdfGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always yield_value(T &yielded) noexcept {
+            value = std::addressof(yielded);
+            return {};
+        }
+        void return_void() noexcept {
+        }
+        void unhandled_exception() {
+            error = std::current_exception();
+        }
+    };
+
+    /// Input iterator over the yielded values
+    class Iterator {
+      public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        explicit Iterator(std::coroutine_handle<promise_type> handle = nullptr)
+            : handle(handle) {
+        }
+
+        T &operator*() const {
+            return *handle.promise().value;
+        }
+        T *operator->() const {
+            return handle.promise().value;
+        }
+        Iterator &operator++() {
+            resume(handle);
+            return *this;
+        }
+        bool operator==(const Iterator &it) const {
+            return done() == it.done();
+        }
+        bool operator!=(const Iterator &it) const {
+            return done() != it.done();
+        }
+
+      private:
+        bool done() const {
+            return !handle || handle.done();
+        }
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    HdfGenerator(const HdfGenerator &) = delete;
+    HdfGenerator &operator=(const HdfGenerator &) = delete;
+    HdfGenerator(HdfGenerator &&other) noexcept
+        : handle(std::exchange(other.handle, nullptr)) {
+    }
+    HdfGenerator &operator=(HdfGenerator &&other) noexcept {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, nullptr);
+        return *this;
+    }
+    /// Destroys the suspended coroutine, the rest of the sequence is not produced
+    ~HdfGenerator() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    /// Runs the coroutine until the first value
+    Iterator begin() {
+        resume(handle);
+        return Iterator(handle);
+    }
+    Iterator end() {
+        return Iterator();
+    }
+
+  private:
+    explicit HdfGenerator(std::coroutine_handle<promise_type> handle)
+        : handle(handle) {
+    }
+
+    /// Resumes the coroutine and rethrows its exception
+    static void resume(std::coroutine_handle<promise_type> handle) {
+        handle.resume();
+        if (handle.promise().error) {
+            std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/// \returns A generator of the tiles of an SData item, see HdfItem::tiles
+/// \param item the SData item, it must outlive the generator
+/// \param shape the shape of the tiles
+template <class T> HdfGenerator<HdfTile<T>> generateTiles(HdfItem &item, std::vector<int32> shape) {
+    for (auto &tile : item.tiles<T>(shape)) {
+        co_yield tile;
+    }
+}
+
+/// \returns A generator of the batches of records of a VData field, see HdfItem::records
+/// \param item the VData item, it must outlive the generator
+/// \param field the name of the field
+/// \param batchSize the number of records in a batch
+template <class T> HdfGenerator<HdfRecordBatch<T>> generateRecords(HdfItem &item, std::string field, int32 batchSize) {
+    for (auto &batch : item.records<T>(field, batchSize)) {
+        co_yield batch;
+    }
+}
+}
+
+#endif
+
+#endif // HDF4CPP_HDFGENERATOR_H
@@ -0,0 +1,174 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFGEOLOCATION_H
+#define HDF4CPP_HDFGEOLOCATION_H
+
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// A point on the Earth in degrees
+struct HdfGeoPoint {
+    float64 latitude;
+    float64 longitude;
+};
+
+/// A pixel of the geolocation arrays found by a query
+struct HdfPixel {
+    /// The index of the pixel along the first dimension, -1 if no pixel was found
+    int32 row;
+    /// The index of the pixel along the second dimension, -1 if no pixel was found
+    int32 column;
+    /// The great circle distance between the pixel and the queried point in kilometers
+    float64 distance;
+
+    /// \returns true if a pixel was found
+    bool isValid() const {
+        return row >= 0;
+    }
+};
+
+/// A k-d tree over the pixels of 2D latitude and longitude arrays (e.g. the geolocation of a swath).
+/// The pixels are indexed as points on the unit sphere, so the queries are correct
+/// across the antimeridian and near the poles. The pixels whose latitude or longitude is out of range
+/// (e.g. fill values) are not indexed.
+/// The index can be saved to a sidecar file, so it is built only once for a granule.
+/// A sidecar file written by open records the source file (path, modification time, size) and the
+/// latitude and longitude items (name, reference number and shape, the names are not unique),
+/// so it is rebuilt when any of them changes.
+class HdfGeolocationIndex : public HdfObject {
+  public:
+    /// Builds the index from the latitude and longitude SData items, both of them 2D with the same dimensions
+    HdfGeolocationIndex(HdfItem &latitude, HdfItem &longitude);
+    /// Loads an index saved by save
+    /// \param path the path of the sidecar file
+    explicit HdfGeolocationIndex(const std::string &path);
+
+    /// Loads the index from the sidecar file if it was written for the same source file and items,
+    /// otherwise builds it and saves it to the sidecar file
+    /// \param latitude the latitude SData item
+    /// \param longitude the longitude SData item
+    /// \param sourcePath the path of the file of the items, its modification time and size are part of the key
+    /// \param path the path of the sidecar file
+    static HdfGeolocationIndex
+    open(HdfItem &latitude, HdfItem &longitude, const std::string &sourcePath, const std::string &path);
+
+    /// Saves the index to a sidecar file
+    void save(const std::string &path) const;
+
+    /// \returns the dimensions of the geolocation arrays
+    const std::vector<int32> &getDims() const;
+    /// \returns the number of indexed pixels
+    size_t size() const;
+
+    /// \returns the pixel nearest to the point, an invalid pixel if there is none within the maximum distance
+    /// \param point the queried point
+    /// \param maxDistance the maximum distance in kilometers
+    HdfPixel nearest(const HdfGeoPoint &point,
+                     float64 maxDistance = std::numeric_limits<float64>::infinity()) const;
+
+    /// \returns the nearest pixel of every point, the points are divided between worker threads
+    /// \param queries the queried points
+    /// \param maxDistance the maximum distance in kilometers
+    /// \param threads the number of worker threads, 0 means one per hardware thread
+    std::vector<HdfPixel> nearest(const std::vector<HdfGeoPoint> &queries,
+                                  float64 maxDistance = std::numeric_limits<float64>::infinity(),
+                                  size_t threads = 0) const;
+
+    /// \returns the pixels within the radius of the point, in increasing order of distance
+    /// \param point the queried point
+    /// \param radius the radius in kilometers
+    std::vector<HdfPixel> withinRadius(const HdfGeoPoint &point, float64 radius) const;
+
+    /// Extracts the values of the pixels from an SData item of the same granule.
+    /// The first two dimensions of the item must be the dimensions of the geolocation arrays,
+    /// the further dimensions (e.g. bands) are read entirely, so every pixel gives their volume of values.
+    /// The rows of the pixels are read in one batch (see HdfItem::readBatch).
+    /// \param item the SData item
+    /// \param pixels the pixels, the values of the invalid pixels are value initialized
+    /// \param dest the destination vector, the values of the pixels one after the other
+    /// \param maxWaste see HdfItem::readBatch
+    template <class T>
+    void extract(HdfItem &item,
+                 const std::vector<HdfPixel> &pixels,
+                 std::vector<T> &dest,
+                 float64 maxWaste = 2.0) const {
+        std::vector<int32> itemDims = item.getDims();
+        if (itemDims.size() < 2 || itemDims[0] != dims[0] || itemDims[1] != dims[1]) {
+            raiseException(INVALID_RANGES);
+        }
+        size_t volume = 1;
+        for (size_t i = 2; i < itemDims.size(); ++i) {
+            volume *= (size_t)itemDims[i];
+        }
+
+        // one request per row, from the first to the last requested column of the row
+        std::map<int32, std::pair<int32, int32>> rows;
+        for (const auto &pixel : pixels) {
+            if (pixel.isValid()) {
+                auto it = rows.find(pixel.row);
+                if (it == rows.end()) {
+                    rows[pixel.row] = std::make_pair(pixel.column, pixel.column);
+                } else {
+                    it->second.first = std::min(it->second.first, pixel.column);
+                    it->second.second = std::max(it->second.second, pixel.column);
+                }
+            }
+        }
+        std::vector<std::vector<Range>> requests;
+        std::map<int32, size_t> requestOf;
+        for (const auto &row : rows) {
+            std::vector<Range> ranges(itemDims.size());
+            ranges[0] = Range(row.first, 1);
+            ranges[1] = Range(row.second.first, row.second.second - row.second.first + 1);
+            for (size_t i = 2; i < itemDims.size(); ++i) {
+                ranges[i] = Range(0, itemDims[i]);
+            }
+            requestOf[row.first] = requests.size();
+            requests.push_back(ranges);
+        }
+        std::vector<std::vector<T>> values;
+        item.readBatch(values, requests, maxWaste);
+
+        dest.assign(pixels.size() * volume, T());
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            if (pixels[i].isValid()) {
+                const std::vector<T> &row = values[requestOf[pixels[i].row]];
+                size_t offset = (size_t)(pixels[i].column - rows[pixels[i].row].first) * volume;
+                std::copy(row.begin() + offset, row.begin() + offset + volume, dest.begin() + i * volume);
+            }
+        }
+    }
+
+  private:
+    /// Builds the tree over the points in [begin, end)
+    void build(std::vector<int32> &order, size_t begin, size_t end);
+    void searchNearest(size_t begin, size_t end, const float64 *query, size_t &best, float64 &bestChord) const;
+    void searchRadius(size_t begin, size_t end, const float64 *query, float64 chord, std::vector<size_t> &found) const;
+    HdfPixel makePixel(size_t node, float64 chord) const;
+
+    /// \returns the key of the sidecar file: the source file, its state and the latitude and longitude items
+    static std::string getSidecarKey(HdfItem &latitude, HdfItem &longitude, const std::string &sourcePath);
+
+    /// The sidecar key of the index, empty if it was not made by open
+    std::string key;
+    std::vector<int32> dims;
+    /// The points of the tree nodes on the unit sphere (x, y, z), the node of [begin, end) is at (begin + end) / 2
+    std::vector<float64> points;
+    /// The linear pixel index of the tree nodes
+    std::vector<int32> pixels;
+    /// The split axis of the tree nodes
+    std::vector<uint8> axes;
+};
+}
+
+#endif // HDF4CPP_HDFGEOLOCATION_H
@@ -0,0 +1,124 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFHIERARCHY_H
+#define HDF4CPP_HDFHIERARCHY_H
+
+#include <hdf4cpp/HdfFile.h>
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// An item of the hierarchy snapshot
+struct HdfNode {
+    /// The reference of the item, HdfItemRef::get attaches to it
+    HdfItemRef ref;
+    /// The name of the item
+    std::string name;
+    /// The indices of the member nodes (only VGroups have members), without the edges closing a cycle
+    std::vector<size_t> children;
+    /// The indices of the VGroup nodes which contain this node, without the edges closing a cycle
+    std::vector<size_t> parents;
+};
+
+/// The access of a parallel visitor (see HdfHierarchy::visitParallel) to the item of a node.
+/// The hdf library is not thread safe, so the item is attached, used and detached under a lock
+/// which is shared by every file.
+class HdfNodeAccess {
+  public:
+    /// Calls the function with the attached item of the node while holding the lock,
+    /// the item is detached before the lock is released
+    /// \param function callable with (HdfItem& item), it must not keep the item
+    /// \returns The result of the function
+    template <class Function>
+    auto withItem(Function &&function) const -> decltype(function(std::declval<HdfItem &>())) {
+        std::lock_guard<std::mutex> lock(*mutex);
+        HdfItem item = node->ref.get();
+        return function(item);
+    }
+
+  private:
+    friend class HdfHierarchy;
+    HdfNodeAccess(const HdfNode *node, std::mutex *mutex)
+        : node(node)
+        , mutex(mutex) {
+    }
+
+    const HdfNode *node;
+    std::mutex *mutex;
+};
+
+/// A snapshot of the whole structure of a file.
+/// The VGroup graph is walked once, every item appears once even if it is the member of more VGroups,
+/// and the edges which would close a cycle are removed, so the nodes form a directed acyclic graph.
+/// The roots are the lone VGroups and VData (in the order of HdfFile::Iterator),
+/// then a VGroup of every cycle which is not reachable from them (VGroups of a cycle are not lone),
+/// followed by the SData which are not members of any VGroup.
+class HdfHierarchy : public HdfObject {
+  public:
+    /// Called for the nodes of the hierarchy
+    /// \returns false if the members of the node should not be visited (pruning)
+    typedef std::function<bool(const HdfNode &node)> Visitor;
+    /// Called for the nodes of the hierarchy on the threads of visitParallel,
+    /// the item of the node is used through the access
+    /// \returns false if the members of the node should not be visited (pruning)
+    typedef std::function<bool(const HdfNode &node, const HdfNodeAccess &access)> ParallelVisitor;
+
+    /// Builds the snapshot, attaching to every item once
+    explicit HdfHierarchy(const HdfFile &file);
+    HdfHierarchy(const HdfHierarchy &) = delete;
+    HdfHierarchy &operator=(const HdfHierarchy &) = delete;
+
+    /// \returns the number of nodes
+    size_t size() const;
+    /// \returns the node with the given index
+    const HdfNode &getNode(size_t index) const;
+    /// \returns the indices of the root nodes
+    const std::vector<size_t> &getRoots() const;
+    /// \returns the index of the node of an item
+    /// \param type the type of the item
+    /// \param ref the reference number of the item
+    /// \returns size() if there is no such node
+    size_t find(Type type, int32 ref) const;
+
+    /// \returns the edges (parent, member) which were removed because they close a cycle
+    const std::vector<std::pair<size_t, size_t>> &getCycleEdges() const;
+    /// \returns true if the VGroup graph of the file has cycles
+    bool hasCycles() const;
+
+    /// Visits every reachable node once, depth first, the parents before their members
+    /// \param visitor called for the nodes, returning false prunes the members of the node
+    void visit(const Visitor &visitor) const;
+
+    /// Visits the nodes like visit, but the visitor calls run on a thread pool.
+    /// A node is visited after its first visited parent, siblings may be visited in any order.
+    /// The hdf accesses are serialized by the access given to the visitor (see HdfNodeAccess::withItem),
+    /// the rest of the work of the visitors runs in parallel.
+    /// \param visitor called for the nodes, returning false prunes the members of the node
+    /// \param threads the number of worker threads, 0 means one per hardware thread
+    /// \note The visitor must not attach to items (HdfItemRef::get) other than through the access
+    void visitParallel(const ParallelVisitor &visitor, size_t threads = 0) const;
+
+  private:
+    /// Reads the names and the members of the nodes from the given index on, adding the new members
+    void expand(size_t first);
+    size_t addNode(const HdfItemRef &ref);
+    void removeCycles();
+
+    std::vector<HdfNode> nodes;
+    std::vector<size_t> roots;
+    std::map<std::pair<Type, int32>, size_t> index;
+    std::vector<std::pair<size_t, size_t>> cycleEdges;
+};
+}
+
+#endif // HDF4CPP_HDFHIERARCHY_H
@@ -5,12 +5,22 @@
 #ifndef HDF4CPP_HDFITEM_H
 #define HDF4CPP_HDFITEM_H
 
+#include <hdf4cpp/HdfAggregation.h>
+#include <hdf4cpp/HdfAllocator.h>
+#include <hdf4cpp/HdfBatch.h>
 #include <hdf4cpp/HdfDefines.h>
 #include <hdf4cpp/HdfException.h>
 #include <hdf4cpp/HdfFile.h>
+#include <hdf4cpp/HdfLayout.h>
+#include <hdf4cpp/HdfMemoryBudget.h>
+#include <hdf4cpp/HdfScratchPool.h>
+#include <hdf4cpp/HdfStatistics.h>
+#include <hdf4cpp/HdfTypeTraits.h>
 
 #include <algorithm>
 #include <hdf.h>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <vector>
@@ -34,17 +44,18 @@ struct Range {
         , stride(stride) {
     }
 
-    /// What would be the number of data to read, if we read in this range
+    /// The number of data to read in this range (the quantity, whatever the stride is)
     int32 size() const {
-        if (!stride) {
-            return 0;
-        }
-        return quantity / stride;
+        return quantity;
     }
 
-    /// Checks if the range is correct for a specific dimension
+    /// Checks if the range is correct for a specific dimension:
+    /// the last index read (begin + (quantity - 1) * stride) must be in the dimension
     bool check(const int32 &dim) const {
-        return begin >= 0 || begin < dim || quantity >= 0 || begin + quantity <= dim || stride > 0;
+        if (begin < 0 || quantity < 0 || stride <= 0) {
+            return false;
+        }
+        return !quantity || (long long)begin + (long long)(quantity - 1) * stride < dim;
     }
 
     /// Fills a range vector with a dimension array
@@ -55,11 +66,32 @@ struct Range {
     }
 };
 
+/// A closed interval of coordinate values, the default interval contains every value except NaN
+struct HdfInterval {
+    float64 min;
+    float64 max;
+
+    HdfInterval(float64 min = -std::numeric_limits<float64>::infinity(),
+                float64 max = std::numeric_limits<float64>::infinity())
+        : min(min)
+        , max(max) {
+    }
+};
+
 class HdfAttribute;
+class HdfDimension;
+class HdfItemRef;
+template <class T> class HdfTileSequence;
+template <class T> class HdfRecordSequence;
+template <class T> class HdfArrayView;
 
 /// Represents an hdf item
 class HdfItem : public HdfObject {
   public:
+    /// A destination vector for the reads of large data for SIMD kernels:
+    /// aligned to 64 bytes, backed by huge pages where supported and not zeroed before the read (see HdfAllocator)
+    template <class T> using Buffer = std::vector<T, HdfAllocator<T>>;
+
     HdfItem(const HdfItem &item) = delete;
     HdfItem(HdfItem &&other) noexcept;
     HdfItem &operator=(const HdfItem &item) = delete;
@@ -67,24 +99,126 @@ class HdfItem : public HdfObject {
 
     /// \returns The name of the item
     std::string getName() const;
+    /// \returns The reference number of the item, unique among the items of its type in the file
+    /// (the names are not unique, see HdfFile::getAll)
+    int32 getRef() const;
 
     /// \returns The dimensions of the item
     /// \note This operation is not supported for every item type
     std::vector<int32> getDims();
 
+    /// \returns The dimensions of the item with their names and scales, see HdfDimension
+    /// \note This operation is only supported for SData items
+    std::vector<HdfDimension> getDimensions() const;
+
+    /// \returns The dimension of the item with the given index
+    /// \param index the index of the dimension
+    /// \note This operation is only supported for SData items
+    HdfDimension getDimension(int32 index) const;
+
+    /// \returns The ranges of the indices whose dimension scale values are in the given intervals.
+    /// The monotonic scales are binary searched, the other ones through a sorted index,
+    /// in this case the range is the smallest one holding every matching index.
+    /// The scales and their indices are cached per file, see HdfDimension.
+    /// \param intervals the coordinate interval for every dimension, missing ones cover the whole dimension
+    /// \note A range is empty (its quantity is 0) if no value of the scale is in the interval
+    std::vector<Range> getCoordinateRanges(const std::vector<HdfInterval> &intervals) const;
+
+    /// Reads the data whose coordinates are in the given intervals, see getCoordinateRanges
+    /// \param dest the destination vector, it is empty if the intervals match no data
+    /// \param intervals the coordinate interval for every dimension
+    /// \returns the ranges which have been read
+    template <class T, class Alloc>
+    std::vector<Range> readByCoordinates(std::vector<T, Alloc> &dest, const std::vector<HdfInterval> &intervals) {
+        std::vector<Range> ranges = getCoordinateRanges(intervals);
+        for (const auto &range : ranges) {
+            if (!range.quantity) {
+                dest.clear();
+                return ranges;
+            }
+        }
+        read(dest, ranges);
+        return ranges;
+    }
+
     /// \returns the attribute of the item with the given name
     /// \param name the name of the attribute
     /// \note If there are multiple attributes with the same name then the first
     /// will be returned
     HdfAttribute getAttribute(const std::string &name) const;
 
+    /// \returns the attribute of the item with the given name, or the error if there is none.
+    /// Nothing is thrown for a missing attribute, so it is cheap to probe for optional attributes.
+    /// \param name the name of the attribute
+    HdfResult<HdfAttribute> tryGetAttribute(const std::string &name) const;
+
+    /// \returns the names of all the attributes of the item
+    std::vector<std::string> getAttributeNames() const;
+
     /// Reads the entire data from the item
     /// \param dest the destination vector in which the data will be stored
-    template <class T> void read(std::vector<T> &dest) {
+    template <class T, class Alloc> void read(std::vector<T, Alloc> &dest) {
+        tryRead(dest).value();
+    }
+
+    /// Reads the data from the item in a specified range
+    /// \param dest the destination vector in which the data will be stored
+    /// \param ranges specifies the range in which the data will be read
+    template <class T, class Alloc> void read(std::vector<T, Alloc> &dest, std::vector<Range> ranges) {
+        tryRead(dest, std::move(ranges)).value();
+    }
+
+    /// Reads the entire data from the item without throwing, see read
+    /// \param dest the destination vector in which the data will be stored
+    /// \returns the error if the item cannot be read into the vector
+    template <class T, class Alloc> HdfStatus tryRead(std::vector<T, Alloc> &dest) {
         switch (item->getType()) {
         case SDATA: {
-            HdfDatasetItem *dItem = dynamic_cast<HdfDatasetItem *>(item.get());
-            dItem->read(dest);
+            HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+            return dItem->tryRead(dest);
+        }
+        case GRIMAGE: {
+            HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+            std::vector<Range> ranges;
+            return iItem->tryRead(dest, ranges, INTERLACE_PIXEL);
+        }
+        default:
+            return error(INVALID_OPERATION);
+        }
+    }
+
+    /// Reads the data from the item in a specified range without throwing, see read
+    /// \param dest the destination vector in which the data will be stored
+    /// \param ranges specifies the range in which the data will be read
+    /// \returns the error if the ranges are invalid or the item cannot be read into the vector
+    template <class T, class Alloc> HdfStatus tryRead(std::vector<T, Alloc> &dest, std::vector<Range> ranges) {
+        switch (item->getType()) {
+        case SDATA: {
+            HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+            return dItem->tryRead(dest, ranges);
+        }
+        case GRIMAGE: {
+            HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+            return iItem->tryRead(dest, ranges, INTERLACE_PIXEL);
+        }
+        default:
+            return error(INVALID_OPERATION);
+        }
+    }
+
+    /// Reads a window of a GR image with the components in the given order.
+    /// The dimensions of an image are its rows and columns (see getDims),
+    /// a window holds every component of its pixels (see getComponentCount).
+    /// \param dest the destination vector, it holds rows * columns * components values
+    /// \param ranges the range of the rows and the range of the columns, with optional strides
+    /// \param interlace the order of the components in the destination, see Interlace
+    /// \note This operation is only supported for GR image items
+    template <class T, class Alloc>
+    void readImage(std::vector<T, Alloc> &dest, std::vector<Range> ranges, Interlace interlace = INTERLACE_PIXEL) {
+        switch (item->getType()) {
+        case GRIMAGE: {
+            HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+            iItem->read(dest, ranges, interlace);
             break;
         }
         default:
@@ -92,14 +226,66 @@ class HdfItem : public HdfObject {
         }
     }
 
-    /// Reads the data from the item in a specified range
-    /// \param dest the destination vector in which the data will be stored
+    /// Reads a window of a GR image directly into a buffer of the caller, see readImage
+    /// \param dest the destination buffer
+    /// \param size the number of values the buffer can hold
+    /// \param ranges the range of the rows and the range of the columns, with optional strides
+    /// \param interlace the order of the components in the destination, see Interlace
+    template <class T>
+    void readImage(T *dest, size_t size, std::vector<Range> ranges, Interlace interlace = INTERLACE_PIXEL) {
+        switch (item->getType()) {
+        case GRIMAGE: {
+            HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+            iItem->read(dest, size, ranges, interlace);
+            break;
+        }
+        default:
+            raiseException(INVALID_OPERATION);
+        }
+    }
+
+    /// \returns The number of components of a pixel (e.g. 3 for RGB images)
+    /// \note This operation is only supported for GR image items
+    int32 getComponentCount() const;
+
+    /// \returns true if the image has a palette
+    /// \note This operation is only supported for GR image items
+    bool hasPalette() const;
+
+    /// \returns The dimensions of the palette: the number of entries and the number of components of an entry
+    /// \note This operation is only supported for GR image items
+    std::vector<int32> getPaletteDims() const;
+
+    /// Reads the palette of the image, the components of an entry are adjacent
+    /// \param dest the destination vector, it holds entries * components values
+    /// \note This operation is only supported for GR image items which have a palette
+    template <class T, class Alloc> void readPalette(std::vector<T, Alloc> &dest) {
+        switch (item->getType()) {
+        case GRIMAGE: {
+            HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+            iItem->readPalette(dest);
+            break;
+        }
+        default:
+            raiseException(INVALID_OPERATION);
+        }
+    }
+
+    /// Reads the entire data into a vector of the C++ type which belongs to the data type of the item,
+    /// then passes that vector to the visitor. The read is instantiated once per number type.
+    /// \param visitor callable with std::vector<T>& for every readable type T (see HdfTypeTraits.h)
+    template <class Visitor> void readAny(Visitor &&visitor) {
+        readAny(std::forward<Visitor>(visitor), std::vector<Range>());
+    }
+
+    /// Reads the data in a specified range and passes it to the visitor, see readAny(Visitor &&)
+    /// \param visitor callable with std::vector<T>& for every readable type T
     /// \param ranges specifies the range in which the data will be read
-    template <class T> void read(std::vector<T> &dest, std::vector<Range> ranges) {
+    template <class Visitor> void readAny(Visitor &&visitor, std::vector<Range> ranges) {
         switch (item->getType()) {
         case SDATA: {
-            HdfDatasetItem *dItem = dynamic_cast<HdfDatasetItem *>(item.get());
-            dItem->read(dest, ranges);
+            HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+            dItem->readAny(visitor, ranges);
             break;
         }
         default:
@@ -107,30 +293,205 @@ class HdfItem : public HdfObject {
         }
     }
 
+    /// Reads the data in a specified range band by band along the first dimension,
+    /// in the C++ type which belongs to the data type of the item (see readAny).
+    /// Only one band is held in memory at a time.
+    /// \param visitor callable with (std::vector<T>&, int32 rows) for every readable type T,
+    /// the band vector may be moved away by the visitor
+    /// \param bandSize the maximum size of a band in bytes, a band holds at least one row
+    /// \param ranges specifies the range in which the data will be read
+    template <class Visitor>
+    void readAnyBands(Visitor &&visitor, size_t bandSize, std::vector<Range> ranges = std::vector<Range>()) {
+        switch (item->getType()) {
+        case SDATA: {
+            HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+            dItem->readAnyBands(visitor, bandSize, ranges);
+            break;
+        }
+        default:
+            raiseException(INVALID_OPERATION);
+        }
+    }
+
+    /// Reads the data in a specified range within the memory budget (see HdfMemoryBudget).
+    /// If the data fits into the available budget then it is read at once,
+    /// otherwise it is streamed in bands along the first dimension which fit into the budget.
+    /// \param callback callable with (std::vector<T>&, int32 rows) for every band,
+    /// the band vector may be moved away by the callback
+    /// \param ranges specifies the range in which the data will be read
+    /// \note Fails with OUT_OF_BUDGET if not even one row fits into the budget
+    template <class T, class Callback>
+    void readStreamed(Callback &&callback, std::vector<Range> ranges = std::vector<Range>()) {
+        switch (item->getType()) {
+        case SDATA: {
+            HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+            dItem->readStreamed<T>(callback, ranges);
+            break;
+        }
+        default:
+            raiseException(INVALID_OPERATION);
+        }
+    }
+
+    /// Reads every field of the records batch by batch, only one batch is held in memory at a time.
+    /// The records are packed: the fields of a record are adjacent, in the order of the fields of the item,
+    /// in the byte order of the machine.
+    /// \param callback callable with (std::vector<uint8>& batch, int32 records) for every batch,
+    /// the batch vector may be moved away by the callback
+    /// \param batchSize the maximum size of a batch in bytes, a batch holds at least one record
+    /// \note This operation is only supported for VData items
+    template <class Callback> void readRecordBatches(Callback &&callback, size_t batchSize) {
+        switch (item->getType()) {
+        case VDATA: {
+            HdfDataItem *vItem = static_cast<HdfDataItem *>(item.get());
+            vItem->readRecordBatches(callback, batchSize);
+            break;
+        }
+        default:
+            raiseException(INVALID_OPERATION);
+        }
+    }
+
+    /// Reads every field of some records, packed like the batches of readRecordBatches
+    /// \param dest the destination vector
+    /// \param records the number of records to be read
+    /// \param first the index of the first record to be read
+    /// \note This operation is only supported for VData items
+    void readRecords(std::vector<uint8> &dest, int32 records, int32 first);
+
+    /// \returns The hdf number type of the data (DFNT_*)
+    /// \note This operation is only supported for SData and GR image items
+    int32 getDataType() const;
+
+    /// Reads the data reduced block by block (e.g. 2x2 mean pooling).
+    /// The data is streamed in row bands, only the reduced data is held in memory.
+    /// \param dest the destination vector, holds the reduced data in row major order
+    /// \param block the block size for every dimension (missing dimensions are not reduced)
+    /// \param aggregation how a block is reduced to one value
+    /// \param ranges the region which will be reduced (the strides must be 1)
+    template <class Out>
+    void readAggregated(std::vector<Out> &dest,
+                        const std::vector<int32> &block,
+                        Aggregation aggregation,
+                        std::vector<Range> ranges = std::vector<Range>()) {
+        switch (item->getType()) {
+        case SDATA: {
+            HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+            dItem->readAggregated(dest, block, aggregation, ranges);
+            break;
+        }
+        default:
+            raiseException(INVALID_OPERATION);
+        }
+    }
+
+    /// Reads many ranges of the data at once.
+    /// Overlapping and nearby ranges are merged into a single read in row major order,
+    /// then the data of every request is copied out of the merged read.
+    /// \param dests the destination vectors, one for every request
+    /// \param requests the ranges of every request (see Range)
+    /// \param maxWaste a merged read may be at most this many times larger than the requested data
+    template <class T>
+    void readBatch(std::vector<std::vector<T>> &dests,
+                   std::vector<std::vector<Range>> requests,
+                   float64 maxWaste = 2.0) {
+        switch (item->getType()) {
+        case SDATA: {
+            HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+            dItem->readBatch(dests, requests, maxWaste);
+            break;
+        }
+        default:
+            raiseException(INVALID_OPERATION);
+        }
+    }
+
+    /// Computes statistics over the data without holding the whole data in memory.
+    /// The data is read band by band while the previous bands are reduced on worker threads.
+    /// \param options the statistics options, see HdfStatisticsOptions
+    /// \param ranges the region which will be reduced
+    HdfStatistics getStatistics(const HdfStatisticsOptions &options = HdfStatisticsOptions(),
+                                std::vector<Range> ranges = std::vector<Range>());
+
     /// Reads the given field from the item
     /// \param dest the destination vector in which the data will be stored
     /// \param field the name of the field
-    /// \param records the number of records to be read
-    template <class T> void read(std::vector<T> &dest, const std::string &field, int32 records = 0) {
+    /// \param records the number of records to be read, 0 means every record from the first one
+    /// \param first the index of the first record to be read
+    template <class T, class Alloc>
+    void read(std::vector<T, Alloc> &dest, const std::string &field, int32 records = 0, int32 first = 0) {
+        tryRead(dest, field, records, first).value();
+    }
+
+    /// Reads the given field from the item without throwing, see read
+    /// \returns the error if the field cannot be read into the vector
+    template <class T, class Alloc>
+    HdfStatus tryRead(std::vector<T, Alloc> &dest, const std::string &field, int32 records = 0, int32 first = 0) {
         switch (item->getType()) {
         case VDATA: {
-            HdfDataItem *vItem = dynamic_cast<HdfDataItem *>(item.get());
-            vItem->read(dest, field, records);
-            break;
+            HdfDataItem *vItem = static_cast<HdfDataItem *>(item.get());
+            return vItem->tryRead(dest, field, records, first);
         }
         default:
-            raiseException(INVALID_OPERATION);
+            return error(INVALID_OPERATION);
         }
     }
 
+    /// \returns The number of records of the item
+    /// \note This operation is only supported for VData items
+    int32 getRecordCount() const;
+
+    /// \returns How the data is stored in the file: chunking, compression, stored size and data blocks
+    /// \note Every chunk is queried for its data blocks, so this is slow for datasets with many chunks
+    /// \note This operation is only supported for SData items
+    HdfStorageLayout getStorageLayout() const;
+
+    /// \returns How the records are stored in the file: record size, fields, interlace, linked blocks and data blocks
+    /// \note This operation is only supported for VData items
+    HdfRecordLayout getRecordLayout() const;
+
+    /// \returns A lazy sequence of the tiles of the data, see HdfTileSequence.
+    /// A tile is read when the iterator reaches it, so stopping early does not read the rest of the data.
+    /// \param shape the shape of the tiles, missing dimensions cover the whole dimension
+    /// \note The item must outlive the sequence
+    template <class T> HdfTileSequence<T> tiles(const std::vector<int32> &shape) {
+        return HdfTileSequence<T>(this, shape);
+    }
+
+    /// \returns A lazy sequence of the batches of records of a field, see HdfRecordSequence
+    /// \param field the name of the field
+    /// \param batchSize the number of records in a batch
+    /// \note The item must outlive the sequence
+    template <class T> HdfRecordSequence<T> records(const std::string &field, int32 batchSize) {
+        return HdfRecordSequence<T>(this, field, batchSize);
+    }
+
     class Iterator;
     Iterator begin() const;
     Iterator end() const;
 
-    friend HdfItem HdfFile::get(const std::string &name) const;
+    /// \returns references to the members of the item, fetched with a single call
+    /// and without attaching to them (only VGroup items have members)
+    /// \note Members which are not SData, VGroup or VData items are skipped
+    std::vector<HdfItemRef> getRefs() const;
+
+    /// \returns references to the VGroups which directly contain the item
+    /// \note The membership index of the file is built by the first call and reused by every item of the file
+    std::vector<HdfItemRef> getParents() const;
+
+    /// \returns the path of the item: the names of the containing VGroups and the name of the item joined by '/'
+    /// \note If the item is reachable on more paths then the first of getPaths is returned
+    std::string getPath() const;
+
+    /// \returns all the paths on which the item is reachable (see getPath)
+    std::vector<std::string> getPaths() const;
+
+    friend HdfResult<HdfItem> HdfFile::tryGet(const std::string &name) const;
     friend std::vector<HdfItem> HdfFile::getAll(const std::string &name) const;
     friend HdfItem HdfFile::Iterator::operator*();
     friend class HdfAttribute;
+    friend class HdfItemRef;
+    template <class T> friend class HdfArrayView;
 
   private:
     /// The base class of the item classes
@@ -148,15 +509,37 @@ class HdfItem : public HdfObject {
 
         /// Get the id which is held by this object
         virtual int32 getId() const = 0;
+        /// Get the reference number of the item
+        virtual int32 getRef() const = 0;
         /// Get the name of the item
         virtual std::string getName() const = 0;
         /// Get the dimensions of the item
         virtual std::vector<int32> getDims() = 0;
         /// Get the attribute from the item given by its name
         virtual HdfAttribute getAttribute(const std::string &name) const = 0;
+        /// Get the attribute from the item given by its name, a missing attribute is an error instead of an exception
+        virtual HdfResult<HdfAttribute> tryGetAttribute(const std::string &name) const = 0;
+        /// Get the names of the attributes of the item
+        virtual std::vector<std::string> getAttributeNames() const = 0;
+
+        /// Set the memory budget of the file which the reads of the item charge
+        void setBudget(const std::shared_ptr<HdfMemoryBudget> &budget) {
+            this->budget = budget;
+        }
+        /// Get the memory budget of the file, it is passed to the items reached from this one
+        const std::shared_ptr<HdfMemoryBudget> &getBudget() const {
+            return budget;
+        }
 
       protected:
+        /// Charges the bytes of a read against the memory budgets, see HdfMemoryBudget
+        /// \returns the charge, it is empty if the bytes do not fit
+        HdfMemoryBudget::Charge charge(size_t bytes) const {
+            return HdfMemoryBudget::charge(budget.get(), bytes);
+        }
+
         int32 id;
+        std::shared_ptr<HdfMemoryBudget> budget;
     };
     /// Item class for the SData items
     class HdfDatasetItem : public HdfItemBase {
@@ -165,60 +548,415 @@ class HdfItem : public HdfObject {
         ~HdfDatasetItem();
 
         int32 getId() const;
+        int32 getRef() const;
         std::string getName() const;
         std::vector<int32> getDims();
         HdfAttribute getAttribute(const std::string &name) const;
+        HdfResult<HdfAttribute> tryGetAttribute(const std::string &name) const;
+        std::vector<std::string> getAttributeNames() const;
 
         /// Reads the data in a specific range. See Range
         /// \param dest The destination vector
         /// \param ranges The vector of ranges
-        template <class T> void read(std::vector<T> &dest, std::vector<Range> &ranges) {
-            std::vector<int32> dims = getDims();
+        template <class T, class Alloc> void read(std::vector<T, Alloc> &dest, std::vector<Range> &ranges) {
+            tryRead(dest, ranges).value();
+        }
+
+        /// Reads the whole data
+        /// \param dest The destination vector
+        template <class T, class Alloc> void read(std::vector<T, Alloc> &dest) {
+            tryRead(dest).value();
+        }
+
+        /// Reads the data in a specific range, the failure is returned instead of thrown
+        /// \param dest The destination vector
+        /// \param ranges The vector of ranges
+        template <class T, class Alloc> HdfStatus tryRead(std::vector<T, Alloc> &dest, std::vector<Range> &ranges) {
+            const std::vector<int32> &dims = getInfo().dims;
+            int32 dataType = getInfo().dataType;
             Range::fill(ranges, dims);
-            int32 length = 1;
+            if (ranges.size() != dims.size()) {
+                return error(INVALID_RANGES);
+            }
+            // the number of values may exceed int32 (e.g. global mosaics), only its bytes must fit into size_t
+            size_t length = 1;
             for (size_t i = 0; i < ranges.size(); ++i) {
                 if (!ranges[i].check(dims[i])) {
-                    raiseException(INVALID_RANGES);
+                    return error(INVALID_RANGES);
+                }
+                size_t count = (size_t)ranges[i].size();
+                if (count && length > std::numeric_limits<size_t>::max() / sizeof(T) / count) {
+                    return error(INVALID_RANGES);
                 }
-                length *= ranges[i].size();
+                length *= count;
+            }
+            if (!isCompatibleNumberType<T>(dataType)) {
+                return error(isReadableNumberType(dataType) ? TYPE_MISMATCH : INVALID_DATA_TYPE);
+            }
+            HdfMemoryBudget::Charge charged = charge(length * sizeof(T));
+            if (!charged) {
+                return error(OUT_OF_BUDGET);
             }
-            auto it = typeSizeMap.find(dataType);
-            if (it != typeSizeMap.end()) {
-                if ((size_t)it->second != sizeof(T)) {
-                    raiseException(BUFFER_SIZE_NOT_ENOUGH);
+            dest.resize(length);
+            return tryReadHyperslab(dest.data(), ranges, sizeof(T));
+        }
+
+        /// Reads the whole data, the failure is returned instead of thrown.
+        /// Data which fits into one SDreaddata call (see MAX_READ_SIZE) is read without building ranges.
+        /// \param dest The destination vector
+        template <class T, class Alloc> HdfStatus tryRead(std::vector<T, Alloc> &dest) {
+            const std::vector<int32> &dims = getInfo().dims;
+            int32 dataType = getInfo().dataType;
+            size_t length = 1;
+            for (const auto &dim : dims) {
+                size_t count = (size_t)std::max<int32>(0, dim);
+                if (count && length > std::numeric_limits<size_t>::max() / sizeof(T) / count) {
+                    return error(INVALID_RANGES);
                 }
-            } else {
-                raiseException(INVALID_DATA_TYPE);
+                length *= count;
+            }
+            if (length * sizeof(T) > MAX_READ_SIZE || dims.empty() || dims.size() > MAX_DIMENSION) {
+                std::vector<Range> ranges;
+                return tryRead(dest, ranges);
+            }
+            if (!isCompatibleNumberType<T>(dataType)) {
+                return error(isReadableNumberType(dataType) ? TYPE_MISMATCH : INVALID_DATA_TYPE);
+            }
+            HdfMemoryBudget::Charge charged = charge(length * sizeof(T));
+            if (!charged) {
+                return error(OUT_OF_BUDGET);
             }
             dest.resize(length);
-            std::vector<int32> start, quantity, stride;
-            for (const auto &range : ranges) {
-                start.push_back(range.begin);
-                quantity.push_back(range.quantity);
-                stride.push_back(range.stride);
+            return tryReadWhole(dest.data());
+        }
+
+        /// Reads many ranges at once, see HdfItem::readBatch
+        template <class T>
+        void readBatch(std::vector<std::vector<T>> &dests,
+                       std::vector<std::vector<Range>> &requests,
+                       float64 maxWaste) {
+            const std::vector<int32> &dims = getInfo().dims;
+            int32 dataType = getInfo().dataType;
+            if (!isCompatibleNumberType<T>(dataType)) {
+                raiseException(isReadableNumberType(dataType) ? TYPE_MISMATCH : INVALID_DATA_TYPE);
             }
+            dests.resize(requests.size());
 
-            if (SDreaddata(id, start.data(), stride.data(), quantity.data(), dest.data()) == FAIL) {
-                raiseException(STATUS_RETURN_FAIL);
+            // requests with stride cannot be merged, they are read one by one
+            std::vector<HdfBox> boxes;
+            std::vector<size_t> boxRequests;
+            for (size_t i = 0; i < requests.size(); ++i) {
+                std::vector<Range> &ranges = requests[i];
+                Range::fill(ranges, dims);
+                HdfBox box;
+                bool strided = false;
+                for (size_t j = 0; j < ranges.size(); ++j) {
+                    if (j >= dims.size() || !ranges[j].check(dims[j])) {
+                        raiseException(INVALID_RANGES);
+                    }
+                    strided = strided || ranges[j].stride != 1;
+                    box.begin.push_back(ranges[j].begin);
+                    box.count.push_back(ranges[j].quantity);
+                }
+                if (strided) {
+                    read(dests[i], ranges);
+                } else {
+                    boxes.push_back(box);
+                    boxRequests.push_back(i);
+                }
+            }
+
+            HdfReadPlan plan = planCoalescedReads(boxes, maxWaste);
+            // the destinations of the merged requests are charged for the whole batch, the buffers one by one
+            size_t requested = 0;
+            for (const auto &box : boxes) {
+                requested += box.volume() * sizeof(T);
+            }
+            HdfMemoryBudget::Charge charged = charge(requested);
+            if (!charged) {
+                raiseException(OUT_OF_BUDGET);
+            }
+            std::vector<Range> ranges(dims.size());
+            for (size_t i = 0; i < plan.reads.size(); ++i) {
+                const HdfBox &read = plan.reads[i];
+                for (size_t j = 0; j < dims.size(); ++j) {
+                    ranges[j] = Range(read.begin[j], read.count[j]);
+                }
+                HdfMemoryBudget::Charge bufferCharged = charge(read.volume() * sizeof(T));
+                if (!bufferCharged) {
+                    raiseException(OUT_OF_BUDGET);
+                }
+                HdfScratchPool::Buffer buffer = HdfScratchPool::current().acquire(read.volume() * sizeof(T));
+                readHyperslab(buffer.data(), ranges, sizeof(T));
+                for (size_t j = 0; j < boxes.size(); ++j) {
+                    if (plan.readOf[j] == i) {
+                        std::vector<T> &dest = dests[boxRequests[j]];
+                        dest.resize(boxes[j].volume());
+                        copyBox(buffer.as<T>(), read, dest.data(), boxes[j]);
+                    }
+                }
             }
         }
 
-        /// Reads the whole data
-        /// \param dest The destination vector
-        template <class T> void read(std::vector<T> &dest) {
-            std::vector<int32> dims = getDims();
-            std::vector<Range> ranges;
-            for (const auto &dim : dims) {
-                ranges.push_back(Range(0, dim));
+        /// Reads the data in a specific range into a vector of the type matching the data type
+        /// and passes it to the visitor
+        /// \param visitor Callable with std::vector<T>& for every readable type T
+        /// \param ranges The vector of ranges
+        template <class Visitor> void readAny(Visitor &visitor, std::vector<Range> &ranges) {
+            AnyReader<Visitor> reader{this, visitor, ranges};
+            if (!dispatchNumberType(getInfo().dataType, reader)) {
+                raiseException(INVALID_DATA_TYPE);
+            }
+        }
+
+        /// Reads the data band by band in its own type, see HdfItem::readAnyBands
+        template <class Visitor> void readAnyBands(Visitor &visitor, size_t bandSize, std::vector<Range> &ranges) {
+            Range::fill(ranges, getInfo().dims);
+            if (ranges.empty()) {
+                raiseException(INVALID_RANGES);
+            }
+            BandReader<Visitor> reader{this, visitor, bandSize, ranges};
+            if (!dispatchNumberType(getInfo().dataType, reader)) {
+                raiseException(INVALID_DATA_TYPE);
+            }
+        }
+
+        /// \returns The hdf number type of the data
+        int32 getDataType() const {
+            return getInfo().dataType;
+        }
+
+        /// Reads the data reduced block by block, see HdfItem::readAggregated
+        template <class Out>
+        void readAggregated(std::vector<Out> &dest,
+                            const std::vector<int32> &block,
+                            Aggregation aggregation,
+                            std::vector<Range> &ranges) {
+            Range::fill(ranges, getInfo().dims);
+            for (size_t i = 0; i < ranges.size(); ++i) {
+                if (ranges[i].stride != 1 || ranges[i].quantity <= 0 ||
+                    (i < block.size() && block[i] <= 0)) {
+                    raiseException(INVALID_RANGES);
+                }
+            }
+            AggregatedReader<Out> reader{this, dest, block, aggregation, ranges};
+            if (!dispatchNumberType(getInfo().dataType, reader)) {
+                raiseException(INVALID_DATA_TYPE);
+            }
+        }
+
+        /// Computes statistics over the data, see HdfItem::getStatistics
+        HdfStatistics getStatistics(const HdfStatisticsOptions &options, std::vector<Range> &ranges);
+
+        /// Queries the storage layout, see HdfItem::getStorageLayout
+        HdfStorageLayout getStorageLayout() const;
+
+        /// Reads the fill value of the dataset
+        /// \returns false if the dataset has no fill value
+        template <class T> bool getFillValue(T &fill) {
+            return SDgetfillvalue(id, &fill) != FAIL;
+        }
+
+        /// Reads the data in a range band by band along the first dimension
+        /// \param bandRows The number of rows (elements of the first dimension) in one band
+        /// \param ranges The vector of ranges, the first range is split into bands
+        /// \param callback Called with the band data and the number of rows in the band,
+        /// the band vector may be moved away by the callback
+        template <class T, class Callback>
+        void readBands(int32 bandRows, const std::vector<Range> &ranges, Callback &&callback) {
+            std::vector<T> band;
+            std::vector<Range> bandRanges = ranges;
+            const Range &first = ranges.front();
+            int32 rows = first.size();
+            for (int32 row = 0; row < rows; row += bandRows) {
+                int32 count = std::min(bandRows, rows - row);
+                bandRanges[0] = Range(first.begin + row * first.stride, count, first.stride);
+                read(band, bandRanges);
+                callback(band, count);
+            }
+        }
+
+        /// Reads the data at once or band by band, whichever fits into the memory budget, see HdfItem::readStreamed
+        template <class T, class Callback> void readStreamed(Callback &callback, std::vector<Range> &ranges) {
+            Range::fill(ranges, getInfo().dims);
+            if (ranges.empty()) {
+                raiseException(INVALID_RANGES);
+            }
+            size_t rowSize = sizeof(T);
+            for (size_t i = 1; i < ranges.size(); ++i) {
+                rowSize *= std::max<int32>(1, ranges[i].size());
+            }
+            size_t rows = std::max<int32>(1, ranges[0].size());
+            size_t fitting = HdfMemoryBudget::getAvailable(budget.get()) / rowSize;
+            readBands<T>((int32)std::max<size_t>(1, std::min(rows, fitting)), ranges, callback);
+        }
+
+        /// Reads the values given by their start, stride and count along every dimension
+        /// into a buffer which is big enough to hold them, see HdfArrayView
+        void readSlab(void *dest, std::vector<int32> start, std::vector<int32> stride, std::vector<int32> edges) {
+            if (SDreaddata(id, start.data(), stride.data(), edges.data(), dest) == FAIL) {
+                raiseException(STATUS_RETURN_FAIL);
             }
-            read(dest, ranges);
         }
 
       private:
-        int32 _size;
-        int32 dataType{};
-        std::string name;
-        std::vector<int32> dims;
+        /// Reads a checked range of the data into a buffer which is big enough to hold it
+        /// \param valueSize the size of one value in the buffer
+        void readHyperslab(void *dest, const std::vector<Range> &ranges, size_t valueSize) {
+            tryReadHyperslab(dest, ranges, valueSize).value();
+        }
+        /// readHyperslab without throwing.
+        /// A range larger than MAX_READ_SIZE bytes is read with more SDreaddata calls: it is split along
+        /// the given dimension, and an index of that dimension which is still too large is split along the next one,
+        /// so every call fills a contiguous part of the buffer.
+        HdfStatus
+        tryReadHyperslab(void *dest, const std::vector<Range> &ranges, size_t valueSize, size_t dimension = 0) {
+            if (ranges.empty()) {
+                return tryReadOnce(dest, ranges);
+            }
+            size_t inner = valueSize;
+            for (size_t i = dimension + 1; i < ranges.size(); ++i) {
+                inner *= (size_t)ranges[i].size();
+            }
+            const Range &whole = ranges[dimension];
+            int32 count = whole.size();
+            if (inner * count <= MAX_READ_SIZE) {
+                return tryReadOnce(dest, ranges);
+            }
+            bool further = inner > MAX_READ_SIZE && dimension + 1 < ranges.size();
+            int32 step = (int32)std::max<size_t>(1, std::min<size_t>(count, MAX_READ_SIZE / inner));
+            uint8 *part = static_cast<uint8 *>(dest);
+            std::vector<Range> parts = ranges;
+            for (int32 index = 0; index < count; index += step) {
+                int32 indices = std::min(step, count - index);
+                parts[dimension] = Range(whole.begin + index * whole.stride, indices, whole.stride);
+                HdfStatus status = further ? tryReadHyperslab(part, parts, valueSize, dimension + 1)
+                                           : tryReadOnce(part, parts);
+                if (!status) {
+                    return status;
+                }
+                part += inner * indices;
+            }
+            return HdfStatus();
+        }
+        /// Reads the whole data with one SDreaddata call into a buffer which is big enough to hold it
+        HdfStatus tryReadWhole(void *dest) {
+            const std::vector<int32> &dims = getInfo().dims;
+            int32 start[MAX_DIMENSION];
+            int32 quantity[MAX_DIMENSION];
+            int32 stride[MAX_DIMENSION];
+            for (size_t i = 0; i < dims.size(); ++i) {
+                start[i] = 0;
+                quantity[i] = dims[i];
+                stride[i] = 1;
+            }
+            if (SDreaddata(id, start, stride, quantity, dest) == FAIL) {
+                return error(STATUS_RETURN_FAIL);
+            }
+            return HdfStatus();
+        }
+        /// Reads a checked range of the data with one SDreaddata call
+        HdfStatus tryReadOnce(void *dest, const std::vector<Range> &ranges) {
+            int32 start[MAX_DIMENSION];
+            int32 quantity[MAX_DIMENSION];
+            int32 stride[MAX_DIMENSION];
+            if (ranges.size() > MAX_DIMENSION) {
+                return error(INVALID_RANGES);
+            }
+            for (size_t i = 0; i < ranges.size(); ++i) {
+                start[i] = ranges[i].begin;
+                quantity[i] = ranges[i].size();
+                stride[i] = ranges[i].stride;
+            }
+
+            if (SDreaddata(id, start, stride, quantity, dest) == FAIL) {
+                return error(STATUS_RETURN_FAIL);
+            }
+            return HdfStatus();
+        }
+
+        struct StatisticsReader;
+
+        template <class T>
+        HdfStatistics computeStatistics(const HdfStatisticsOptions &options, const std::vector<Range> &ranges);
+
+        /// Instantiates the aggregating read once per number type
+        template <class Out> struct AggregatedReader {
+            HdfDatasetItem *item;
+            std::vector<Out> &dest;
+            const std::vector<int32> &block;
+            Aggregation aggregation;
+            std::vector<Range> &ranges;
+
+            template <class T> void operator()(HdfTypeTag<T>) {
+                std::vector<int32> shape;
+                for (const auto &range : ranges) {
+                    shape.push_back(range.quantity);
+                }
+                HdfBlockReducer<T, Out> reducer(aggregation, shape, block);
+                const std::vector<int32> &outShape = reducer.getOutputShape();
+                size_t length = 1;
+                for (const auto &dim : outShape) {
+                    length *= dim;
+                }
+                dest.resize(length);
+                item->readBands<T>(reducer.getBandRows(STREAM_BUFFER_SIZE),
+                                   ranges,
+                                   [&](std::vector<T> &band, int32 rows) {
+                                       reducer.consume(band.data(), rows, dest.data());
+                                   });
+            }
+        };
+
+        /// Instantiates the band read once per number type, see readAnyBands
+        template <class Visitor> struct BandReader {
+            HdfDatasetItem *item;
+            Visitor &visitor;
+            size_t bandSize;
+            std::vector<Range> &ranges;
+
+            template <class T> void operator()(HdfTypeTag<T>) {
+                size_t rowSize = sizeof(T);
+                for (size_t i = 1; i < ranges.size(); ++i) {
+                    rowSize *= std::max<int32>(1, ranges[i].size());
+                }
+                int32 bandRows = (int32)std::max<size_t>(1, bandSize / rowSize);
+                item->readBands<T>(bandRows, ranges, [&](std::vector<T> &band, int32 rows) { visitor(band, rows); });
+            }
+        };
+
+        /// Instantiates the typed read once per number type, see readAny
+        template <class Visitor> struct AnyReader {
+            HdfDatasetItem *item;
+            Visitor &visitor;
+            std::vector<Range> &ranges;
+
+            template <class T> void operator()(HdfTypeTag<T>) {
+                std::vector<T> dest;
+                item->read(dest, ranges);
+                visitor(dest);
+            }
+        };
+
+        /// The metadata of the dataset
+        struct Info {
+            std::string name;
+            std::vector<int32> dims;
+            int32 dataType;
+            size_t size;
+        };
+
+        /// \returns The metadata of the dataset, it is queried from the file by the first call
+        const Info &getInfo() const {
+            if (!infoLoaded) {
+                loadInfo();
+            }
+            return info;
+        }
+        void loadInfo() const;
+
+        mutable Info info{};
+        mutable bool infoLoaded = false;
     };
     /// Item class for VGroup items
     class HdfGroupItem : public HdfItemBase {
@@ -227,13 +965,18 @@ class HdfItem : public HdfObject {
         ~HdfGroupItem();
 
         int32 getId() const;
+        int32 getRef() const;
         std::string getName() const;
         std::vector<int32> getDims();
 
         HdfAttribute getAttribute(const std::string &name) const;
+        HdfResult<HdfAttribute> tryGetAttribute(const std::string &name) const;
+        std::vector<std::string> getAttributeNames() const;
 
       private:
-        std::string name;
+        /// The name is queried from the file by the first getName call
+        mutable std::string name;
+        mutable bool nameLoaded = false;
     };
     /// Item class for VData items
     class HdfDataItem : public HdfItemBase {
@@ -243,38 +986,52 @@ class HdfItem : public HdfObject {
         ~HdfDataItem();
 
         int32 getId() const;
+        int32 getRef() const;
 
         std::string getName() const;
 
         std::vector<int32> getDims();
 
         HdfAttribute getAttribute(const std::string &name) const;
+        HdfResult<HdfAttribute> tryGetAttribute(const std::string &name) const;
+        std::vector<std::string> getAttributeNames() const;
 
         /// Reads a specific number of the data of a specific field
         /// The records are simple values
         /// \param dest The destination vector
         /// \param field The specific field name
         /// \param records The number of records to be read
-        template <class T> void read(std::vector<T> &dest, const std::string &field, int32 records) {
+        /// \param first The index of the first record to be read
+        /// \returns The error if the field cannot be read into the vector
+        template <class T, class Alloc>
+        HdfStatus tryRead(std::vector<T, Alloc> &dest, const std::string &field, int32 records, int32 first) {
+            const Info &info = getInfo();
+            if (first < 0 || first > info.nrRecords) {
+                return error(INVALID_RANGES);
+            }
             if (!records) {
-                records = nrRecords;
+                records = info.nrRecords - first;
             }
 
-
             if (VSsetfields(id, field.c_str()) == FAIL) {
-                raiseException(STATUS_RETURN_FAIL);
+                return error(STATUS_RETURN_FAIL);
             }
 
             int32 fieldSize = VSsizeof(id, (char *)field.c_str());
             if (sizeof(T) < (size_t)fieldSize) {
-                raiseException(BUFFER_SIZE_NOT_ENOUGH);
+                return error(BUFFER_SIZE_NOT_ENOUGH);
             }
 
             size_t size = records * fieldSize;
-            std::vector<uint8> buff(size);
+            HdfMemoryBudget::Charge charged = charge(size + records * sizeof(T));
+            if (!charged) {
+                return error(OUT_OF_BUDGET);
+            }
+            HdfScratchPool::Buffer buff = HdfScratchPool::current().acquire(size);
 
-            if (VSread(id, buff.data(), records, interlace) == FAIL) {
-                raiseException(STATUS_RETURN_FAIL);
+            seek(first);
+            if (VSread(id, buff.data(), records, info.interlace) == FAIL) {
+                return error(STATUS_RETURN_FAIL);
             }
             VSseek(id, 0);
 
@@ -283,8 +1040,9 @@ class HdfItem : public HdfObject {
             buffptrs[0] = dest.data();
             if (VSfpack(id, _HDF_VSUNPACK, field.c_str(), buff.data(), size, records, field.c_str(), buffptrs) ==
                 FAIL) {
-                raiseException(STATUS_RETURN_FAIL);
+                return error(STATUS_RETURN_FAIL);
             }
+            return HdfStatus();
         }
 
         /// Reads a specific number of the data of a specific field
@@ -292,54 +1050,253 @@ class HdfItem : public HdfObject {
         /// \param dest The destination matrix (every record is a vector)
         /// \param field The specific field name
         /// \param records The number of records to be read
-        template <class T> void read(std::vector<std::vector<T>> &dest, const std::string &field, int32 records) {
+        /// \param first The index of the first record to be read
+        /// \returns The error if the field cannot be read into the matrix
+        template <class T, class InnerAlloc, class Alloc>
+        HdfStatus tryRead(std::vector<std::vector<T, InnerAlloc>, Alloc> &dest,
+                          const std::string &field,
+                          int32 records,
+                          int32 first) {
+            const Info &info = getInfo();
+            if (first < 0 || first > info.nrRecords) {
+                return error(INVALID_RANGES);
+            }
             if (!records) {
-                records = nrRecords;
+                records = info.nrRecords - first;
             }
 
             if (VSsetfields(id, field.c_str()) == FAIL) {
-                raiseException(STATUS_RETURN_FAIL);
+                return error(STATUS_RETURN_FAIL);
             }
 
             int32 fieldSize = VSsizeof(id, (char *)field.c_str());
             if (fieldSize % sizeof(T) != 0) {
-                raiseException(BUFFER_SIZE_NOT_DIVISIBLE);
+                return error(BUFFER_SIZE_NOT_DIVISIBLE);
             }
 
             size_t size = records * fieldSize;
-            std::vector<uint8> buff(size);
-            if (VSread(id, buff.data(), records, interlace) == FAIL) {
-                raiseException(STATUS_RETURN_FAIL);
+            // the packed records, the unpacked values and the destination vectors
+            HdfMemoryBudget::Charge charged = charge(3 * size);
+            if (!charged) {
+                return error(OUT_OF_BUDGET);
+            }
+            HdfScratchPool::Buffer buff = HdfScratchPool::current().acquire(size);
+            seek(first);
+            if (VSread(id, buff.data(), records, info.interlace) == FAIL) {
+                return error(STATUS_RETURN_FAIL);
             }
             VSseek(id, 0);
 
             int32 divided = fieldSize / sizeof(T);
-            dest.resize(records, std::vector<T>(divided));
-            std::vector<T> linearDest(records * divided);
+            dest.resize(records);
+            HdfScratchPool::Buffer linear = HdfScratchPool::current().acquire(size);
+            T *linearDest = linear.as<T>();
             VOIDP buffptrs[1];
-            buffptrs[0] = linearDest.data();
-            VSfpack(id, _HDF_VSUNPACK, field.c_str(), buff.data(), size, records, field.c_str(), buffptrs);
-            int i = 0;
-            int j;
-            while (i < records) {
-                j = 0;
-                while (j < divided) {
-                    dest[i][j] = linearDest[i * divided + j];
-                    ++j;
-                }
-                ++i;
+            buffptrs[0] = linearDest;
+            if (VSfpack(id, _HDF_VSUNPACK, field.c_str(), buff.data(), size, records, field.c_str(), buffptrs) ==
+                FAIL) {
+                return error(STATUS_RETURN_FAIL);
+            }
+            for (int32 i = 0; i < records; ++i) {
+                dest[i].assign(linearDest + i * divided, linearDest + (i + 1) * divided);
             }
+            return HdfStatus();
         }
 
+        /// \returns The number of records
+        int32 getRecordCount() const {
+            return getInfo().nrRecords;
+        }
+
+        /// Queries the record layout, see HdfItem::getRecordLayout
+        HdfRecordLayout getRecordLayout() const;
+
+        /// Reads the whole records batch by batch, see HdfItem::readRecordBatches
+        template <class Callback> void readRecordBatches(Callback &callback, size_t batchSize) {
+            const Info &info = getInfo();
+            size_t recordSize = (size_t)std::max<int32>(1, info.recordSize);
+            int32 batch = (int32)std::max<size_t>(
+            1, std::min<size_t>(batchSize / recordSize, (size_t)std::numeric_limits<int32>::max()));
+            std::vector<uint8> records;
+            for (int32 first = 0; first < info.nrRecords;) {
+                int32 count = std::min(batch, info.nrRecords - first);
+                readRecords(records, count, first);
+                first += count;
+                callback(records, count);
+            }
+        }
+
+        /// Reads every field of some records, packed in full interlace
+        /// \param dest The destination vector
+        /// \param records The number of records to be read
+        /// \param first The index of the first record to be read
+        void readRecords(std::vector<uint8> &dest, int32 records, int32 first);
+
       private:
-        std::string name;
+        /// Moves the read position to a record (the reads move it back to the first record)
+        void seek(int32 record) {
+            if (record && VSseek(id, record) == FAIL) {
+                raiseException(STATUS_RETURN_FAIL);
+            }
+        }
+
+        /// The metadata of the vdata
+        struct Info {
+            std::string name;
+            int32 nrRecords;
+            int32 interlace;
+            int32 recordSize;
+        };
 
-        int32 nrRecords{};
-        int32 interlace{};
-        int32 recordSize{};
+        /// \returns The metadata of the vdata, it is queried from the file by the first call
+        const Info &getInfo() const {
+            if (!infoLoaded) {
+                loadInfo();
+            }
+            return info;
+        }
+        void loadInfo() const;
+
+        mutable Info info{};
+        mutable bool infoLoaded = false;
     };
 
-    HdfItem(HdfItemBase *item, int32 sId, int32 vId);
+    /// Item class for the GR images
+    class HdfImageItem : public HdfItemBase {
+      public:
+        HdfImageItem(int32 id, const HdfDestroyerChain &chain);
+        ~HdfImageItem();
+
+        int32 getId() const;
+        int32 getRef() const;
+        std::string getName() const;
+        std::vector<int32> getDims();
+        HdfAttribute getAttribute(const std::string &name) const;
+        HdfResult<HdfAttribute> tryGetAttribute(const std::string &name) const;
+        std::vector<std::string> getAttributeNames() const;
+
+        /// Reads a window of the image, see HdfItem::readImage
+        /// \param dest The destination vector
+        /// \param ranges The range of the rows and the range of the columns
+        /// \param interlace The order of the components in the destination
+        template <class T, class Alloc>
+        void read(std::vector<T, Alloc> &dest, std::vector<Range> &ranges, Interlace interlace) {
+            tryRead(dest, ranges, interlace).value();
+        }
+
+        /// Reads a window of the image, the failure is returned instead of thrown
+        /// \param dest The destination vector
+        /// \param ranges The range of the rows and the range of the columns
+        /// \param interlace The order of the components in the destination
+        template <class T, class Alloc>
+        HdfStatus tryRead(std::vector<T, Alloc> &dest, std::vector<Range> &ranges, Interlace interlace) {
+            HdfStatus status = checkType<T>(getInfo().dataType);
+            size_t size = 0;
+            if (!status || !(status = checkWindow(ranges, size))) {
+                return status;
+            }
+            HdfMemoryBudget::Charge charged = charge(size * sizeof(T));
+            if (!charged) {
+                return error(OUT_OF_BUDGET);
+            }
+            dest.resize(size);
+            return readWindow(dest.data(), ranges, interlace);
+        }
+
+        /// Reads a window of the image into a buffer, see HdfItem::readImage
+        /// \param dest The destination buffer
+        /// \param size The number of values the buffer can hold
+        /// \param ranges The range of the rows and the range of the columns
+        /// \param interlace The order of the components in the destination
+        template <class T> void read(T *dest, size_t size, std::vector<Range> &ranges, Interlace interlace) {
+            HdfStatus status = checkType<T>(getInfo().dataType);
+            size_t length = 0;
+            if (status && (status = checkWindow(ranges, length))) {
+                status = (size < length) ? error(BUFFER_SIZE_NOT_ENOUGH) : readWindow(dest, ranges, interlace);
+            }
+            status.value();
+        }
+
+        /// Reads the palette, see HdfItem::readPalette
+        /// \param dest The destination vector
+        template <class T, class Alloc> void readPalette(std::vector<T, Alloc> &dest) {
+            Palette palette = getPalette();
+            if (!palette.entries) {
+                raiseException(INVALID_OPERATION);
+            }
+            checkType<T>(palette.dataType).value();
+            HdfMemoryBudget::Charge charged = charge((size_t)palette.entries * palette.components * sizeof(T));
+            if (!charged) {
+                raiseException(OUT_OF_BUDGET);
+            }
+            dest.resize((size_t)palette.entries * palette.components);
+            readPalette(palette, dest.data());
+        }
+
+        /// \returns The hdf number type of the data
+        int32 getDataType() const {
+            return getInfo().dataType;
+        }
+
+        /// \returns The number of components of a pixel
+        int32 getComponentCount() const {
+            return getInfo().components;
+        }
+
+        /// \returns The number of entries and the number of components of the palette, zeros if there is none
+        std::vector<int32> getPaletteDims() const;
+
+      private:
+        /// The metadata of the image
+        struct Info {
+            std::string name;
+            int32 components;
+            int32 dataType;
+            /// The rows and the columns
+            std::vector<int32> dims;
+        };
+
+        /// The metadata of the palette
+        struct Palette {
+            int32 id;
+            int32 components;
+            int32 dataType;
+            int32 entries;
+        };
+
+        /// \returns The error if the values of the given number type cannot be read into T
+        template <class T> HdfStatus checkType(int32 dataType) const {
+            if (!isCompatibleNumberType<T>(dataType)) {
+                return error(isReadableNumberType(dataType) ? TYPE_MISMATCH : INVALID_DATA_TYPE);
+            }
+            return HdfStatus();
+        }
+
+        /// Checks the ranges of a window
+        /// \param length The number of values in the window
+        /// \returns The error if the ranges are invalid
+        HdfStatus checkWindow(std::vector<Range> &ranges, size_t &length) const;
+        /// Reads a checked window into a buffer which is big enough to hold it
+        HdfStatus readWindow(void *dest, const std::vector<Range> &ranges, Interlace interlace) const;
+        /// \returns The metadata of the palette, the number of entries is 0 if there is no palette
+        Palette getPalette() const;
+        /// Reads the palette into a buffer which is big enough to hold it
+        void readPalette(const Palette &palette, void *dest) const;
+
+        /// \returns The metadata of the image, it is queried from the file by the first call
+        const Info &getInfo() const {
+            if (!infoLoaded) {
+                loadInfo();
+            }
+            return info;
+        }
+        void loadInfo() const;
+
+        mutable Info info{};
+        mutable bool infoLoaded = false;
+    };
+
+    HdfItem(HdfItemBase *item, int32 sId, int32 vId, int32 grId, const std::shared_ptr<HdfMemoryBudget> &budget);
 
     /// Holds an item object address
     std::unique_ptr<HdfItemBase> item;
@@ -347,16 +1304,26 @@ class HdfItem : public HdfObject {
     /// The file handle ids (needed by the iterator)
     int32 sId;
     int32 vId;
+    int32 grId;
 };
 
 /// HdfItem iterator, gives the possibility to iterate over the items from the
 /// item
 class HdfItem::Iterator : public HdfObject, public std::iterator<std::bidirectional_iterator_tag, HdfItem> {
   public:
-    Iterator(int32 sId, int32 vId, int32 key, int32 index, Type type, const HdfDestroyerChain &chain)
+    Iterator(int32 sId,
+             int32 vId,
+             int32 grId,
+             const std::shared_ptr<HdfMemoryBudget> &budget,
+             int32 key,
+             int32 index,
+             Type type,
+             const HdfDestroyerChain &chain)
         : HdfObject(type, ITERATOR, chain)
         , sId(sId)
         , vId(vId)
+        , grId(grId)
+        , budget(budget)
         , key(key)
         , index(index) {
     }
@@ -394,23 +1361,279 @@ class HdfItem::Iterator : public HdfObject, public std::iterator<std::bidirectio
         }
         if (Visvs(key, ref)) {
             int32 id = VSattach(vId, ref, "r");
-            return HdfItem(new HdfDataItem(id, chain), sId, vId);
+            return HdfItem(new HdfDataItem(id, chain), sId, vId, grId, budget);
         } else if (Visvg(key, ref)) {
             int32 id = Vattach(vId, ref, "r");
-            return HdfItem(new HdfGroupItem(id, chain), sId, vId);
+            return HdfItem(new HdfGroupItem(id, chain), sId, vId, grId, budget);
+        } else if (tag == DFTAG_RIG) {
+            int32 id = GRselect(grId, GRreftoindex(grId, (uint16)ref));
+            return HdfItem(new HdfImageItem(id, chain), sId, vId, grId, budget);
         } else {
             int32 id = SDselect(sId, SDreftoindex(sId, ref));
-            return HdfItem(new HdfDatasetItem(id, chain), sId, vId);
+            return HdfItem(new HdfDatasetItem(id, chain), sId, vId, grId, budget);
         }
     }
 
   private:
     int32 sId;
     int32 vId;
+    int32 grId;
+    std::shared_ptr<HdfMemoryBudget> budget;
     int32 key;
 
     int32 index;
 };
+
+/// A lightweight reference to an item (its tag and reference number).
+/// Creating it costs nothing, the item is attached only by HdfItemRef::get.
+class HdfItemRef : public HdfObject {
+  public:
+    /// \returns the tag of the item (DFTAG_*)
+    int32 getTag() const;
+    /// \returns the reference number of the item
+    int32 getRef() const;
+
+    /// \returns the referenced item, attaches to it
+    HdfItem get() const;
+
+    /// \returns the item type belonging to a tag
+    /// \param tag the tag of the item
+    /// \param type set to the item type if the tag is known
+    /// \returns false if the tag does not belong to an item type
+    static bool typeOfTag(int32 tag, Type &type);
+
+    friend class HdfItem;
+    friend class HdfFile;
+    friend class HdfHierarchy;
+
+  private:
+    HdfItemRef(int32 sId,
+               int32 vId,
+               int32 grId,
+               const std::shared_ptr<HdfMemoryBudget> &budget,
+               int32 tag,
+               int32 ref,
+               Type type,
+               const HdfDestroyerChain &chain);
+
+    int32 sId;
+    int32 vId;
+    int32 grId;
+    /// The memory budget of the file, given to the referenced item
+    std::shared_ptr<HdfMemoryBudget> budget;
+    int32 tag;
+    int32 ref;
+};
+
+/// A tile of the data of an SData item
+template <class T> struct HdfTile {
+    /// The region of the tile
+    HdfBox box;
+    /// The data of the tile in row major order
+    std::vector<T> data;
+};
+
+/// A lazy sequence of the tiles of an SData item, in row major order of the tiles.
+/// The tiles are read one by one while the sequence is iterated, the tile buffer is reused.
+/// The tiles at the end of the dimensions are smaller if the shape does not divide the dimensions.
+template <class T> class HdfTileSequence {
+  public:
+    /// Input iterator over the tiles, the referenced tile is valid until the next increment
+    class Iterator {
+      public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef HdfTile<T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef HdfTile<T> *pointer;
+        typedef HdfTile<T> &reference;
+
+        explicit Iterator(HdfTileSequence *sequence = nullptr)
+            : sequence(sequence) {
+        }
+
+        HdfTile<T> &operator*() const {
+            return sequence->tile;
+        }
+        HdfTile<T> *operator->() const {
+            return &sequence->tile;
+        }
+        Iterator &operator++() {
+            if (!sequence->next()) {
+                sequence = nullptr;
+            }
+            return *this;
+        }
+        bool operator==(const Iterator &it) const {
+            return sequence == it.sequence;
+        }
+        bool operator!=(const Iterator &it) const {
+            return sequence != it.sequence;
+        }
+
+      private:
+        HdfTileSequence *sequence;
+    };
+
+    HdfTileSequence(HdfItem *item, const std::vector<int32> &shape)
+        : item(item)
+        , dims(item->getDims())
+        , shape(shape) {
+        this->shape.resize(dims.size());
+        for (size_t i = 0; i < dims.size(); ++i) {
+            if (i >= shape.size() || this->shape[i] <= 0 || this->shape[i] > dims[i]) {
+                this->shape[i] = dims[i];
+            }
+        }
+    }
+
+    /// Reads the first tile
+    Iterator begin() {
+        grid.assign(dims.size(), 0);
+        for (const auto &dim : dims) {
+            if (dim <= 0) {
+                return end();
+            }
+        }
+        readTile();
+        return Iterator(this);
+    }
+    Iterator end() {
+        return Iterator();
+    }
+
+    /// \returns The number of tiles
+    size_t size() const {
+        size_t size = 1;
+        for (size_t i = 0; i < dims.size(); ++i) {
+            size *= shape[i] ? (dims[i] + shape[i] - 1) / shape[i] : 0;
+        }
+        return size;
+    }
+
+  private:
+    /// Steps to the next tile in row major order
+    /// \returns false if there are no more tiles
+    bool next() {
+        size_t dim = dims.size();
+        while (dim-- > 0) {
+            if (++grid[dim] * shape[dim] < dims[dim]) {
+                readTile();
+                return true;
+            }
+            grid[dim] = 0;
+        }
+        return false;
+    }
+    void readTile() {
+        std::vector<Range> ranges;
+        tile.box.begin.clear();
+        tile.box.count.clear();
+        for (size_t i = 0; i < dims.size(); ++i) {
+            int32 begin = grid[i] * shape[i];
+            int32 count = std::min(shape[i], dims[i] - begin);
+            ranges.push_back(Range(begin, count));
+            tile.box.begin.push_back(begin);
+            tile.box.count.push_back(count);
+        }
+        item->read(tile.data, ranges);
+    }
+
+    HdfItem *item;
+    std::vector<int32> dims;
+    std::vector<int32> shape;
+    std::vector<int32> grid;
+    HdfTile<T> tile;
+};
+
+/// A batch of records of a VData field
+template <class T> struct HdfRecordBatch {
+    /// The index of the first record of the batch
+    int32 first;
+    /// The values of the records (T is a vector if the records of the field are arrays)
+    std::vector<T> data;
+};
+
+/// A lazy sequence of the batches of records of a VData field.
+/// The batches are read one by one while the sequence is iterated, the batch buffer is reused.
+template <class T> class HdfRecordSequence {
+  public:
+    /// Input iterator over the batches, the referenced batch is valid until the next increment
+    class Iterator {
+      public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef HdfRecordBatch<T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef HdfRecordBatch<T> *pointer;
+        typedef HdfRecordBatch<T> &reference;
+
+        explicit Iterator(HdfRecordSequence *sequence = nullptr)
+            : sequence(sequence) {
+        }
+
+        HdfRecordBatch<T> &operator*() const {
+            return sequence->batch;
+        }
+        HdfRecordBatch<T> *operator->() const {
+            return &sequence->batch;
+        }
+        Iterator &operator++() {
+            if (!sequence->next()) {
+                sequence = nullptr;
+            }
+            return *this;
+        }
+        bool operator==(const Iterator &it) const {
+            return sequence == it.sequence;
+        }
+        bool operator!=(const Iterator &it) const {
+            return sequence != it.sequence;
+        }
+
+      private:
+        HdfRecordSequence *sequence;
+    };
+
+    HdfRecordSequence(HdfItem *item, const std::string &field, int32 batchSize)
+        : item(item)
+        , field(field)
+        , batchSize(std::max<int32>(1, batchSize))
+        , records(item->getRecordCount()) {
+    }
+
+    /// Reads the first batch
+    Iterator begin() {
+        batch.first = 0;
+        if (!records) {
+            return end();
+        }
+        readBatch();
+        return Iterator(this);
+    }
+    Iterator end() {
+        return Iterator();
+    }
+
+  private:
+    /// Steps to the next batch
+    /// \returns false if there are no more records
+    bool next() {
+        batch.first += batchSize;
+        if (batch.first >= records) {
+            return false;
+        }
+        readBatch();
+        return true;
+    }
+    void readBatch() {
+        item->read(batch.data, field, std::min(batchSize, records - batch.first), batch.first);
+    }
+
+    HdfItem *item;
+    std::string field;
+    int32 batchSize;
+    int32 records;
+    HdfRecordBatch<T> batch;
+};
 }
 
 #endif // HDF4CPP_HDFITEM_H
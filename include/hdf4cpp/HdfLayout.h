@@ -0,0 +1,76 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFLAYOUT_H
+#define HDF4CPP_HDFLAYOUT_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// How the data of an SData item is stored in the file
+struct HdfStorageLayout {
+    /// The data is stored in chunks, otherwise it is stored contiguously
+    bool chunked = false;
+    /// The dimensions of a chunk, empty if the data is not chunked
+    std::vector<int32> chunkDims;
+    /// The compression method of the data (or of every chunk), COMP_CODE_NONE if the data is not compressed
+    comp_coder_t compression = COMP_CODE_NONE;
+    /// The parameters of the compression, the member which belongs to the method is valid
+    comp_info compressionInfo = comp_info();
+    /// The number of bytes of the data in memory
+    std::uint64_t logicalSize = 0;
+    /// The number of bytes of the data blocks in the file, 0 if nothing is written yet
+    std::uint64_t storedSize = 0;
+    /// The number of data blocks in the file, of all chunks if the data is chunked
+    std::uint64_t blockCount = 0;
+
+    /// \returns true if the data is compressed
+    bool isCompressed() const {
+        return compression != COMP_CODE_NONE;
+    }
+
+    /// \returns The logical size divided by the stored size, NaN if nothing is stored
+    float64 getCompressionRatio() const {
+        return storedSize ? (float64)logicalSize / storedSize : std::numeric_limits<float64>::quiet_NaN();
+    }
+};
+
+/// A field of the records of a VData item
+struct HdfRecordField {
+    /// The name of the field
+    std::string name;
+    /// The number type of the values of the field
+    int32 dataType = 0;
+    /// The number of values of the field in a record
+    int32 order = 0;
+};
+
+/// How the records of a VData item are stored in the file
+struct HdfRecordLayout {
+    /// The number of records
+    int32 recordCount = 0;
+    /// The number of bytes of a record
+    int32 recordSize = 0;
+    /// The fields of a record in their order in the record
+    std::vector<HdfRecordField> fields;
+    /// FULL_INTERLACE if the fields of a record are adjacent, NO_INTERLACE if the values of a field are adjacent
+    int32 interlace = FULL_INTERLACE;
+    /// The size of the linked blocks which hold the appended records
+    int32 linkedBlockSize = 0;
+    /// The number of linked blocks in a block table
+    int32 linkedBlockCount = 0;
+    /// The number of bytes of the data blocks in the file
+    std::uint64_t storedSize = 0;
+    /// The number of data blocks in the file
+    std::uint64_t blockCount = 0;
+};
+}
+
+#endif // HDF4CPP_HDFLAYOUT_H
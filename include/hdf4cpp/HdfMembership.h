@@ -0,0 +1,58 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFMEMBERSHIP_H
+#define HDF4CPP_HDFMEMBERSHIP_H
+
+#include <hdf4cpp/HdfObject.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// Reverse membership index of a file: maps the items to the VGroups which contain them.
+/// It is built by scanning every VGroup of the file once.
+/// The VGroups of the library internal classes (e.g. the CDF0.0 group of the SD interface)
+/// are not taken into account, neither as parents nor as items.
+class HdfMembershipIndex : public HdfObject {
+  public:
+    /// Builds the index, attaching to every VGroup once
+    /// \param vId the id of the file opened with Hopen
+    explicit HdfMembershipIndex(int32 vId);
+    HdfMembershipIndex(const HdfMembershipIndex &) = delete;
+    HdfMembershipIndex &operator=(const HdfMembershipIndex &) = delete;
+
+    /// \returns the reference numbers of the VGroups which directly contain the item
+    /// \param type the type of the item
+    /// \param ref the reference number of the item
+    const std::vector<int32> &getParents(Type type, int32 ref) const;
+
+    /// \returns the name of a VGroup
+    /// \param ref the reference number of the VGroup
+    const std::string &getGroupName(int32 ref) const;
+
+    /// \returns every chain of VGroups leading to the item, from a VGroup without parent to the direct parent
+    /// \param type the type of the item
+    /// \param ref the reference number of the item
+    /// \note A VGroup is not repeated in a chain, so cyclic groups give finite results
+    std::vector<std::vector<int32>> getGroupPaths(Type type, int32 ref) const;
+
+    /// \returns the index of an open file, it is built by the first call
+    /// and shared by the items of the file until the file is closed
+    /// \param vId the id of the file opened with Hopen
+    /// \param token the token of the destroyer chain of the file (see HdfDestroyerChain::getToken)
+    static std::shared_ptr<const HdfMembershipIndex> forFile(int32 vId, const std::weak_ptr<const void> &token);
+
+  private:
+    void collectPaths(int32 group, std::vector<int32> &path, std::vector<std::vector<int32>> &paths) const;
+
+    std::map<std::pair<Type, int32>, std::vector<int32>> parents;
+    std::map<int32, std::string> groupNames;
+};
+}
+
+#endif // HDF4CPP_HDFMEMBERSHIP_H
@@ -0,0 +1,112 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFMEMORYBUDGET_H
+#define HDF4CPP_HDFMEMORYBUDGET_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <memory>
+#include <mutex>
+
+namespace hdf4cpp {
+
+/// The usage of a memory budget
+struct HdfMemoryStats {
+    /// The limit in bytes, 0 means unlimited
+    size_t limit;
+    /// The bytes charged by the reads which are running
+    size_t inUse;
+    /// The largest number of bytes which were charged by the running reads at once
+    size_t peak;
+    /// The number of reads which were refused because they did not fit into the budget
+    size_t rejected;
+};
+
+/// Limits the memory which the reads in flight may allocate at once.
+/// Every read (SData with the batch reads and the array views, VData, GR image, palette and attribute)
+/// charges the bytes of its destination and scratch buffers against the budget of the process
+/// and the budget of its file while it runs. The reads into a buffer of the caller charge only their scratch buffers.
+/// The charges are given back when the read returns, the results then belong to the caller:
+/// the budget does not limit the memory held by the results, and the peak is the largest in-flight usage.
+/// A read which does not fit fails with OUT_OF_BUDGET instead of allocating,
+/// the streaming reads (see HdfItem::readStreamed) read in bands which fit instead.
+/// The budgets are unlimited by default.
+class HdfMemoryBudget {
+  public:
+    /// The bytes charged by a read, they are given back to the budgets when destroyed
+    class Charge {
+      public:
+        Charge(Charge &&other) noexcept;
+        Charge(const Charge &) = delete;
+        Charge &operator=(const Charge &) = delete;
+        ~Charge();
+
+        /// \returns false if the bytes did not fit into the budgets, so nothing was charged
+        explicit operator bool() const {
+            return accepted;
+        }
+
+      private:
+        friend class HdfMemoryBudget;
+        Charge(HdfMemoryBudget *file, size_t bytes, bool accepted);
+
+        HdfMemoryBudget *file;
+        size_t bytes;
+        bool accepted;
+    };
+
+    /// \param limit the limit in bytes, 0 means unlimited
+    explicit HdfMemoryBudget(size_t limit = 0);
+    HdfMemoryBudget(const HdfMemoryBudget &) = delete;
+    HdfMemoryBudget &operator=(const HdfMemoryBudget &) = delete;
+
+    /// Sets the limit, the running reads are not affected
+    /// \param limit the limit in bytes, 0 means unlimited
+    void setLimit(size_t limit);
+    /// \returns the limit in bytes, 0 means unlimited
+    size_t getLimit() const;
+
+    /// \returns the current usage of the budget
+    HdfMemoryStats getStats() const;
+    /// Restarts the peak and the rejected count from the current usage
+    void resetStats();
+
+    /// \returns the budget shared by every read of the process
+    static HdfMemoryBudget &process();
+
+    /// \returns the budget of an open file, it is created by the first call for the file.
+    /// HdfFile resolves it once when it is opened and passes it to its items.
+    /// \param sId the id of the file opened with SDstart
+    /// \param token the token of the destroyer chain of the file
+    static std::shared_ptr<HdfMemoryBudget> ofFile(int32 sId, const std::weak_ptr<const void> &token);
+
+    /// Charges the bytes against the process budget and the file budget
+    /// \returns the charge, it is empty (false) if the bytes do not fit into one of the budgets
+    /// \param file the budget of the file, nullptr if only the process budget is charged
+    /// \param bytes the number of bytes
+    static Charge charge(HdfMemoryBudget *file, size_t bytes);
+
+    /// \returns the number of bytes which can be charged at the moment against both budgets
+    /// \param file the budget of the file, nullptr if only the process budget is considered
+    static size_t getAvailable(const HdfMemoryBudget *file);
+
+  private:
+    /// Charges the bytes if they fit
+    /// \param previousPeak set to the peak before the charge, see rollback
+    bool tryCharge(size_t bytes, size_t &previousPeak);
+    /// Takes back a charge made by tryCharge, the peak is restored as if the charge had not been made
+    void rollback(size_t bytes, size_t previousPeak);
+    void release(size_t bytes);
+    size_t getAvailable() const;
+
+    mutable std::mutex mutex;
+    size_t limit;
+    size_t inUse = 0;
+    size_t peak = 0;
+    size_t rejected = 0;
+};
+}
+
+#endif // HDF4CPP_HDFMEMORYBUDGET_H
@@ -7,6 +7,7 @@
 
 #include <hdf4cpp/HdfDefines.h>
 #include <hdf4cpp/HdfException.h>
+#include <hdf4cpp/HdfResult.h>
 
 #include <functional>
 #include <memory>
@@ -62,6 +63,15 @@ class HdfObject {
             chain.emplace_back(new HdfDestroyer(endFunction, id));
         }
 
+        /// \returns a handle which expires when the first destroyer of the chain
+        /// (the one of the file) is destroyed, so it identifies an open file
+        std::weak_ptr<const void> getToken() const {
+            if (chain.empty()) {
+                return std::weak_ptr<const void>();
+            }
+            return chain.front();
+        }
+
       private:
         std::vector<std::shared_ptr<HdfDestroyer>> chain;
     };
@@ -111,6 +121,11 @@ class HdfObject {
         throw HdfException(type, classType, message);
     }
 
+    /// \returns the error of the non-throwing API by its type, see raiseException
+    HdfError error(const ExceptionType &exceptionType) const noexcept {
+        return HdfError{type, classType, exceptionType};
+    }
+
   private:
     /// The type of the object.
     Type type;
@@ -0,0 +1,102 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFPYRAMID_H
+#define HDF4CPP_HDFPYRAMID_H
+
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// The options of building an overview pyramid
+struct HdfPyramidOptions {
+    /// How the 2x2 blocks (4x4 blocks, ...) of the data are reduced to one value of a level
+    Aggregation aggregation = AGGREGATE_MEAN;
+    /// Levels are made until the larger of the first two dimensions of the last level is at most this
+    int32 minSize = 256;
+};
+
+/// Overview levels of an SData item for previews.
+/// Level i holds the data reduced by 2^(i+1) along the first two dimensions (the further dimensions are kept),
+/// so level 0 is half resolution. Every level is computed from the original data, with one streaming read of it.
+/// The values of the levels are float64 regardless of the type of the item.
+/// The pyramid can be cached in a sidecar file, see open.
+class HdfPyramid : public HdfObject {
+  public:
+    /// Builds the pyramid of an SData item, the data is read band by band, only once
+    HdfPyramid(HdfItem &item, const HdfPyramidOptions &options = HdfPyramidOptions());
+    /// Loads a pyramid saved by save
+    /// \param path the path of the cache file
+    explicit HdfPyramid(const std::string &path);
+
+    /// Loads the pyramid of the item from the cache directory if it is there for the same source file
+    /// (path, modification time and size), dataset (name and reference number, the names are not unique)
+    /// and options, otherwise builds it and stores it in the cache
+    /// \param item the SData item
+    /// \param sourcePath the path of the hdf file of the item
+    /// \param cacheDirectory the directory of the cache files, it must exist
+    static HdfPyramid open(HdfItem &item,
+                           const std::string &sourcePath,
+                           const std::string &cacheDirectory,
+                           const HdfPyramidOptions &options = HdfPyramidOptions());
+
+    /// \returns the path of the cache file of the pyramid of the item in the cache directory (see open),
+    /// it changes with the state of the source file
+    static std::string getCachePath(HdfItem &item,
+                                    const std::string &sourcePath,
+                                    const std::string &cacheDirectory,
+                                    const HdfPyramidOptions &options = HdfPyramidOptions());
+
+    /// Saves the pyramid to a cache file
+    void save(const std::string &path) const;
+
+    /// \returns the dimensions of the item
+    const std::vector<int32> &getDims() const;
+    /// \returns the number of levels
+    size_t getLevelCount() const;
+    /// \returns the dimensions of a level
+    const std::vector<int32> &getLevelDims(size_t level) const;
+    /// \returns the reduction factor of a level along the first two dimensions (2 for level 0)
+    int32 getFactor(size_t level) const;
+
+    /// \returns the coarsest level whose factor is at most the scale, so it has at least the wanted resolution
+    /// \param scale the number of original values which belong to one preview value along a dimension
+    /// \note Levels are not finer than level 0, a scale below 2 is served by the item itself
+    size_t getNearestLevel(float64 scale) const;
+
+    /// Reads a window of a level
+    /// \param dest the destination vector
+    /// \param level the level
+    /// \param ranges the window in the coordinates of the level, missing ranges cover the whole dimension
+    void read(std::vector<float64> &dest, size_t level, std::vector<Range> ranges = std::vector<Range>()) const;
+
+    /// Reads a window of the original data at a scale from the nearest level (see getNearestLevel)
+    /// \param dest the destination vector
+    /// \param window the window in the coordinates of the item, along the first two dimensions
+    /// the strides only widen the window to the last index read, along the others they are kept
+    /// \param scale the number of original values which belong to one preview value along a dimension
+    /// \returns the level which was read and the window in its coordinates, which covers the given window
+    std::pair<size_t, std::vector<Range>>
+    readWindow(std::vector<float64> &dest, std::vector<Range> window, float64 scale) const;
+
+  private:
+    /// \returns the key of the pyramid of the item in the cache: the source file, its state, the dataset and the options
+    static std::string getCacheKey(HdfItem &item, const std::string &sourcePath, const HdfPyramidOptions &options);
+
+    /// The cache key of the pyramid, empty if it was not made by open
+    std::string key;
+    std::vector<int32> dims;
+    Aggregation aggregation;
+    int32 minSize;
+    std::vector<std::vector<int32>> levelDims;
+    std::vector<std::vector<float64>> levels;
+};
+}
+
+#endif // HDF4CPP_HDFPYRAMID_H
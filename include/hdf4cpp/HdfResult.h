@@ -0,0 +1,145 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFRESULT_H
+#define HDF4CPP_HDFRESULT_H
+
+#include <hdf4cpp/HdfDefines.h>
+#include <hdf4cpp/HdfException.h>
+
+#include <new>
+#include <utility>
+
+namespace hdf4cpp {
+
+/// The error of a failed operation of the non-throwing API, it is three enums, so it is cheap to create and copy
+struct HdfError {
+    /// The Type of the object which failed
+    Type type;
+    /// The ClassType of the object which failed
+    ClassType classType;
+    /// What went wrong
+    ExceptionType exceptionType;
+
+    /// Throws the HdfException which the throwing API would have thrown
+    NORETURN void raise() const {
+        throw HdfException(type, classType, exceptionType);
+    }
+};
+
+/// The outcome of an operation of the non-throwing API: the value or the error (like std::expected).
+/// Nothing is allocated and no message is built for an error, see HdfError.
+template <class T> class HdfResult {
+  public:
+    HdfResult(T &&value)
+        : ok(true) {
+        new (&stored) T(std::move(value));
+    }
+    HdfResult(const HdfError &error)
+        : ok(false)
+        , error(error) {
+    }
+    HdfResult(HdfResult &&other)
+        : ok(other.ok)
+        , error(other.error) {
+        if (ok) {
+            new (&stored) T(std::move(other.stored));
+        }
+    }
+    HdfResult(const HdfResult &) = delete;
+    HdfResult &operator=(const HdfResult &) = delete;
+    HdfResult &operator=(HdfResult &&) = delete;
+    ~HdfResult() {
+        if (ok) {
+            stored.~T();
+        }
+    }
+
+    /// \returns true if the operation succeeded
+    bool hasValue() const {
+        return ok;
+    }
+    explicit operator bool() const {
+        return ok;
+    }
+
+    /// \returns the error, only valid if the operation failed
+    const HdfError &getError() const {
+        return error;
+    }
+
+    /// \returns the value
+    /// \note Throws the HdfException of the error if the operation failed
+    T &value() {
+        if (!ok) {
+            error.raise();
+        }
+        return stored;
+    }
+    T &operator*() {
+        return value();
+    }
+    T *operator->() {
+        return &value();
+    }
+
+  private:
+    bool ok;
+    HdfError error{};
+    union {
+        T stored;
+    };
+};
+
+/// The outcome of an operation of the non-throwing API which gives no value
+template <> class HdfResult<void> {
+  public:
+    HdfResult()
+        : ok(true) {
+    }
+    HdfResult(const HdfError &error)
+        : ok(false)
+        , error(error) {
+    }
+
+    /// Runs an operation of the throwing API and turns its HdfException into the error
+    template <class Function> static HdfResult capture(Function &&function) {
+        try {
+            function();
+        } catch (const HdfException &exception) {
+            return HdfError{exception.getType(), exception.getClassType(), exception.getExceptionType()};
+        }
+        return HdfResult();
+    }
+
+    /// \returns true if the operation succeeded
+    bool hasValue() const {
+        return ok;
+    }
+    explicit operator bool() const {
+        return ok;
+    }
+
+    /// \returns the error, only valid if the operation failed
+    const HdfError &getError() const {
+        return error;
+    }
+
+    /// Throws the HdfException of the error if the operation failed
+    void value() const {
+        if (!ok) {
+            error.raise();
+        }
+    }
+
+  private:
+    bool ok;
+    HdfError error{};
+};
+
+/// The outcome of an operation of the non-throwing API which gives no value
+typedef HdfResult<void> HdfStatus;
+}
+
+#endif // HDF4CPP_HDFRESULT_H
@@ -0,0 +1,100 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFSCRATCHPOOL_H
+#define HDF4CPP_HDFSCRATCHPOOL_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// A pool of reusable byte buffers for the temporary memory of the reads.
+/// Buffers given back to the pool are kept, so a steady state of reads
+/// does not allocate heap memory for scratch space.
+/// The pool keeps at most a given number of bytes, a buffer which does not fit is freed when it is given back,
+/// so a single huge read does not pin its scratch memory in the pool of every thread.
+/// By default every thread uses its own pool, an other pool (e.g. one arena per file)
+/// can be installed for the current thread with HdfScratchPool::Scope.
+class HdfScratchPool {
+  public:
+    /// A buffer borrowed from a pool, it is given back when destroyed
+    class Buffer {
+      public:
+        Buffer(Buffer &&other) noexcept;
+        Buffer(const Buffer &) = delete;
+        Buffer &operator=(const Buffer &) = delete;
+        ~Buffer();
+
+        /// \returns The address of the buffer, aligned for any fundamental type
+        uint8 *data() const {
+            return block.get();
+        }
+
+        /// \returns The address of the buffer as an array of T
+        template <class T> T *as() const {
+            return reinterpret_cast<T *>(block.get());
+        }
+
+        /// \returns The usable size of the buffer in bytes
+        size_t size() const {
+            return capacity;
+        }
+
+      private:
+        friend class HdfScratchPool;
+        Buffer(HdfScratchPool *pool, std::unique_ptr<uint8[]> block, size_t capacity);
+
+        HdfScratchPool *pool;
+        std::unique_ptr<uint8[]> block;
+        size_t capacity;
+    };
+
+    /// Installs a pool as the current pool of this thread, the previous one is restored when destroyed
+    class Scope {
+      public:
+        explicit Scope(HdfScratchPool &pool);
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        ~Scope();
+
+      private:
+        HdfScratchPool *previous;
+    };
+
+    /// \param maxSize the largest number of bytes kept for reuse
+    explicit HdfScratchPool(size_t maxSize = SCRATCH_POOL_SIZE);
+    HdfScratchPool(const HdfScratchPool &) = delete;
+    HdfScratchPool &operator=(const HdfScratchPool &) = delete;
+
+    /// \returns A buffer of at least the given size
+    Buffer acquire(size_t size);
+
+    /// Frees the buffers which are held by the pool
+    void clear();
+
+    /// \returns The number of heap allocations made by the pool so far
+    size_t getAllocationCount() const;
+
+    /// \returns The number of bytes of the buffers kept for reuse
+    size_t getKeptSize() const;
+
+    /// \returns The pool used by the reads of the current thread
+    static HdfScratchPool &current();
+
+  private:
+    void release(std::unique_ptr<uint8[]> block, size_t capacity);
+
+    mutable std::mutex mutex;
+    std::vector<std::pair<size_t, std::unique_ptr<uint8[]>>> blocks;
+    size_t maxSize;
+    size_t kept = 0;
+    size_t allocations = 0;
+};
+}
+
+#endif // HDF4CPP_HDFSCRATCHPOOL_H
@@ -0,0 +1,126 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFSTATISTICS_H
+#define HDF4CPP_HDFSTATISTICS_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace hdf4cpp {
+
+class HdfThreadPool;
+
+/// Settings of the statistics computation
+struct HdfStatisticsOptions {
+    /// The number of histogram bins, 0 disables the histogram
+    int32 bins = 0;
+    /// The lower bound of the histogram (inclusive)
+    float64 histogramMin = 0.0;
+    /// The upper bound of the histogram (exclusive)
+    float64 histogramMax = 0.0;
+    /// Skip the elements which are equal to the fill value of the dataset
+    bool skipFillValue = true;
+    /// The number of worker threads, 0 means one per hardware thread
+    size_t threads = 0;
+    /// The pool which processes the bands, it is shared by the calls instead of starting threads for every call.
+    /// If it is null then every call starts its own pool of the given number of threads.
+    HdfThreadPool *pool = nullptr;
+};
+
+/// Summary statistics of a dataset.
+/// Invalid elements (fill values and NaNs) are counted only by count.
+struct HdfStatistics {
+    /// The number of elements
+    std::uint64_t count = 0;
+    /// The number of valid elements
+    std::uint64_t validCount = 0;
+    /// The smallest valid value (meaningless if there are no valid elements)
+    float64 min = std::numeric_limits<float64>::infinity();
+    /// The largest valid value (meaningless if there are no valid elements)
+    float64 max = -std::numeric_limits<float64>::infinity();
+    /// The sum of the valid values
+    float64 sum = 0.0;
+    /// The histogram of the valid values, values outside of the histogram bounds are not counted
+    std::vector<std::uint64_t> histogram;
+
+    /// \returns The mean of the valid values, NaN if there are no valid elements
+    float64 mean() const {
+        return validCount ? sum / validCount : std::numeric_limits<float64>::quiet_NaN();
+    }
+
+    /// Merges the statistics of another part of the data into this one
+    void merge(const HdfStatistics &other) {
+        count += other.count;
+        validCount += other.validCount;
+        min = other.min < min ? other.min : min;
+        max = other.max > max ? other.max : max;
+        sum += other.sum;
+        if (histogram.size() < other.histogram.size()) {
+            histogram.resize(other.histogram.size());
+        }
+        for (size_t i = 0; i < other.histogram.size(); ++i) {
+            histogram[i] += other.histogram[i];
+        }
+    }
+};
+
+/// Accumulates the statistics of a contiguous buffer.
+/// The min/max/sum pass keeps its loop free of early exits so it can be vectorized,
+/// the histogram is filled in a second pass only if it is requested.
+/// \param data The buffer
+/// \param length The number of elements in the buffer
+/// \param hasFill Whether the fill value should be skipped
+/// \param fill The fill value
+/// \param options The statistics options (only the histogram settings are used)
+/// \param statistics The statistics to accumulate into
+template <class T>
+void accumulateStatistics(const T *data,
+                          size_t length,
+                          bool hasFill,
+                          T fill,
+                          const HdfStatisticsOptions &options,
+                          HdfStatistics &statistics) {
+    T lowest = std::numeric_limits<T>::max();
+    T highest = std::numeric_limits<T>::lowest();
+    float64 sum = 0.0;
+    size_t valid = 0;
+    for (size_t i = 0; i < length; ++i) {
+        T value = data[i];
+        // value == value filters out the NaNs of the floating point types
+        bool isValid = !(hasFill && value == fill) && value == value;
+        lowest = (isValid && value < lowest) ? value : lowest;
+        highest = (isValid && value > highest) ? value : highest;
+        sum += isValid ? (float64)value : 0.0;
+        valid += isValid;
+    }
+    statistics.count += length;
+    statistics.validCount += valid;
+    statistics.sum += sum;
+    if (valid) {
+        statistics.min = std::min<float64>(statistics.min, lowest);
+        statistics.max = std::max<float64>(statistics.max, highest);
+    }
+
+    if (options.bins > 0 && options.histogramMax > options.histogramMin) {
+        statistics.histogram.resize((size_t)options.bins);
+        float64 scale = options.bins / (options.histogramMax - options.histogramMin);
+        for (size_t i = 0; i < length; ++i) {
+            T value = data[i];
+            if ((hasFill && value == fill) || value != value || value < options.histogramMin ||
+                value >= options.histogramMax) {
+                continue;
+            }
+            size_t bin = (size_t)((value - options.histogramMin) * scale);
+            ++statistics.histogram[std::min(bin, (size_t)options.bins - 1)];
+        }
+    }
+}
+}
+
+#endif // HDF4CPP_HDFSTATISTICS_H
@@ -0,0 +1,75 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFTHREADPOOL_H
+#define HDF4CPP_HDFTHREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// A fixed size pool of worker threads.
+/// The hdf library is not thread safe, so the tasks must not call hdf routines,
+/// they only process data which was read by the thread owning the file.
+class HdfThreadPool {
+  public:
+    /// \param threads The number of worker threads, 0 means one per hardware thread
+    explicit HdfThreadPool(size_t threads = 0);
+    HdfThreadPool(const HdfThreadPool &) = delete;
+    HdfThreadPool &operator=(const HdfThreadPool &) = delete;
+    /// Finishes the queued tasks, then joins the workers
+    ~HdfThreadPool();
+
+    /// \returns The number of worker threads
+    size_t size() const;
+
+    /// Queues a task
+    /// \returns A future which holds the exception thrown by the task (if any)
+    std::future<void> submit(std::function<void()> task);
+
+  private:
+    void work();
+
+    std::vector<std::thread> workers;
+    std::deque<std::packaged_task<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+};
+
+/// Keeps a bounded number of tasks of a pool in flight.
+/// Used by the streaming operations to overlap the reading of the next chunk
+/// with the processing of the previous ones, while the memory usage stays flat.
+class HdfTaskWindow {
+  public:
+    /// \param pool The pool running the tasks
+    /// \param limit The maximum number of tasks in flight
+    HdfTaskWindow(HdfThreadPool &pool, size_t limit);
+    HdfTaskWindow(const HdfTaskWindow &) = delete;
+    HdfTaskWindow &operator=(const HdfTaskWindow &) = delete;
+    /// Waits for the pending tasks, their exceptions are dropped
+    ~HdfTaskWindow();
+
+    /// Queues a task, waits for the oldest one first if the window is full
+    /// \note Rethrows the exception of the task which has been waited for
+    void submit(std::function<void()> task);
+
+    /// Waits for all the pending tasks
+    /// \note Rethrows the first exception thrown by a task
+    void wait();
+
+  private:
+    HdfThreadPool &pool;
+    size_t limit;
+    std::deque<std::future<void>> pending;
+};
+}
+
+#endif // HDF4CPP_HDFTHREADPOOL_H
@@ -0,0 +1,171 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFTYPETRAITS_H
+#define HDF4CPP_HDFTYPETRAITS_H
+
+#include <hdf4cpp/HdfDefines.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace hdf4cpp {
+
+/// Maps an hdf number type (DFNT_*) to the C++ type of one element.
+/// Only the number types which can be read by the library are specialized.
+template <int32 NumberType> struct HdfNumberType {};
+
+template <> struct HdfNumberType<DFNT_CHAR8> {
+    typedef char8 type;
+};
+template <> struct HdfNumberType<DFNT_UCHAR8> {
+    typedef uchar8 type;
+};
+template <> struct HdfNumberType<DFNT_INT8> {
+    typedef int8 type;
+};
+template <> struct HdfNumberType<DFNT_UINT8> {
+    typedef uint8 type;
+};
+template <> struct HdfNumberType<DFNT_INT16> {
+    typedef int16 type;
+};
+template <> struct HdfNumberType<DFNT_UINT16> {
+    typedef uint16 type;
+};
+template <> struct HdfNumberType<DFNT_INT32> {
+    typedef int32 type;
+};
+template <> struct HdfNumberType<DFNT_UINT32> {
+    typedef uint32 type;
+};
+template <> struct HdfNumberType<DFNT_FLOAT32> {
+    typedef float32 type;
+};
+template <> struct HdfNumberType<DFNT_FLOAT64> {
+    typedef float64 type;
+};
+
+/// A compile time list of hdf number types
+template <int32... NumberTypes> struct HdfNumberTypeList {};
+
+/// All the number types which have an HdfNumberType specialization
+typedef HdfNumberTypeList<DFNT_CHAR8,
+                          DFNT_UCHAR8,
+                          DFNT_INT8,
+                          DFNT_UINT8,
+                          DFNT_INT16,
+                          DFNT_UINT16,
+                          DFNT_INT32,
+                          DFNT_UINT32,
+                          DFNT_FLOAT32,
+                          DFNT_FLOAT64>
+HdfReadableNumberTypes;
+
+/// Empty tag type, used to pass a C++ type to a visitor
+template <class T> struct HdfTypeTag {
+    typedef T type;
+};
+
+/// \returns the number type without the native and little endian flags
+constexpr int32 basicNumberType(int32 dataType) {
+    return dataType & DFNT_MASK;
+}
+
+/// \returns true if the number type holds characters (text data is read byte by byte)
+constexpr bool isTextNumberType(int32 dataType) {
+    return basicNumberType(dataType) == DFNT_CHAR8 || basicNumberType(dataType) == DFNT_UCHAR8;
+}
+
+namespace detail {
+template <class T> constexpr bool matchesNumberType(int32, HdfNumberTypeList<>) {
+    return false;
+}
+template <class T, int32 First, int32... Rest>
+constexpr bool matchesNumberType(int32 dataType, HdfNumberTypeList<First, Rest...>) {
+    return (dataType == First && std::is_same<T, typename HdfNumberType<First>::type>::value) ||
+           matchesNumberType<T>(dataType, HdfNumberTypeList<Rest...>());
+}
+constexpr bool isListedNumberType(int32, HdfNumberTypeList<>) {
+    return false;
+}
+template <int32 First, int32... Rest>
+constexpr bool isListedNumberType(int32 dataType, HdfNumberTypeList<First, Rest...>) {
+    return dataType == First || isListedNumberType(dataType, HdfNumberTypeList<Rest...>());
+}
+}
+
+/// \returns true if the library can read data of the given number type
+constexpr bool isReadableNumberType(int32 dataType) {
+    return detail::isListedNumberType(basicNumberType(dataType), HdfReadableNumberTypes());
+}
+
+/// \returns true if data of the given number type can be read into elements of type T.
+/// The C++ type must match the number type exactly, except for text data,
+/// which can be read into any one byte integral type.
+template <class T> constexpr bool isCompatibleNumberType(int32 dataType) {
+    return detail::matchesNumberType<T>(basicNumberType(dataType), HdfReadableNumberTypes()) ||
+           (isTextNumberType(dataType) && std::is_integral<T>::value && sizeof(T) == 1);
+}
+
+/// Calls the visitor with the HdfTypeTag of the C++ type which belongs to the number type
+/// \returns false if the number type is not readable, in this case the visitor is not called
+template <class Visitor> bool dispatchNumberType(int32 dataType, Visitor &visitor) {
+    switch (basicNumberType(dataType)) {
+    case DFNT_CHAR8:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_CHAR8>::type>());
+        return true;
+    case DFNT_UCHAR8:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_UCHAR8>::type>());
+        return true;
+    case DFNT_INT8:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_INT8>::type>());
+        return true;
+    case DFNT_UINT8:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_UINT8>::type>());
+        return true;
+    case DFNT_INT16:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_INT16>::type>());
+        return true;
+    case DFNT_UINT16:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_UINT16>::type>());
+        return true;
+    case DFNT_INT32:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_INT32>::type>());
+        return true;
+    case DFNT_UINT32:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_UINT32>::type>());
+        return true;
+    case DFNT_FLOAT32:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_FLOAT32>::type>());
+        return true;
+    case DFNT_FLOAT64:
+        visitor(HdfTypeTag<HdfNumberType<DFNT_FLOAT64>::type>());
+        return true;
+    default:
+        return false;
+    }
+}
+
+namespace detail {
+/// Gives the size of a value of the number type
+struct ValueSize {
+    size_t &size;
+
+    template <class T> void operator()(HdfTypeTag<T>) {
+        size = sizeof(T);
+    }
+};
+}
+
+/// \returns The number of bytes of a value of the given number type, 0 if the number type is not readable
+inline size_t numberTypeSize(int32 dataType) {
+    size_t size = 0;
+    detail::ValueSize sizer{size};
+    dispatchNumberType(dataType, sizer);
+    return size;
+}
+}
+
+#endif // HDF4CPP_HDFTYPETRAITS_H
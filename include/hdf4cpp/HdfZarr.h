@@ -0,0 +1,66 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#ifndef HDF4CPP_HDFZARR_H
+#define HDF4CPP_HDFZARR_H
+
+#include <hdf4cpp/HdfDefines.h>
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfObject.h>
+#include <hdf4cpp/HdfThreadPool.h>
+
+#include <string>
+#include <vector>
+
+namespace hdf4cpp {
+
+/// Settings of the Zarr export
+struct HdfZarrOptions {
+    /// The shape of the chunks. Missing dimensions cover the whole dimension,
+    /// except the first one, which is chosen so that a chunk is about STREAM_BUFFER_SIZE bytes
+    std::vector<int32> chunks;
+    /// The zlib compression level (0-9)
+    int32 level = 6;
+    /// The number of compressing threads, 0 means one per hardware thread
+    size_t threads = 0;
+    /// The maximum number of chunks waiting for compression, 0 means two per thread
+    size_t maxPendingChunks = 0;
+};
+
+/// Converts SData items into Zarr v2 directory stores:
+/// a directory with the .zarray metadata, the attributes of the item in .zattrs
+/// and one zlib compressed file per chunk, named by the chunk indices joined by '.'.
+/// The data is read in bands of chunk rows on the calling thread (the hdf library is not thread safe),
+/// the chunks of the previous bands are compressed and written by worker threads.
+/// The edge chunks are padded with the fill value of the dataset (0 if it has none).
+class HdfZarrExporter : public HdfObject {
+  public:
+    explicit HdfZarrExporter(const HdfZarrOptions &options = HdfZarrOptions());
+    HdfZarrExporter(const HdfZarrExporter &) = delete;
+    HdfZarrExporter &operator=(const HdfZarrExporter &) = delete;
+
+    /// Exports an SData item
+    /// \param item the SData item
+    /// \param directory the directory of the store, it is created if it does not exist
+    /// (its parent directory has to exist)
+    /// \note Returns when the last chunk is queued, wait() has to be called before using the store
+    void exportDataset(HdfItem &item, const std::string &directory);
+
+    /// Waits until every queued chunk is written
+    /// \note Rethrows the first error of the workers
+    void wait();
+
+  private:
+    struct ChunkWriter;
+
+    void writeFile(const std::string &path, const std::string &content) const;
+    void writeChunk(const std::string &path, const uint8 *data, size_t size) const;
+
+    HdfZarrOptions options;
+    HdfThreadPool pool;
+    HdfTaskWindow window;
+};
+}
+
+#endif // HDF4CPP_HDFZARR_H
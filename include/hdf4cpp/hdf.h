@@ -11,6 +11,28 @@
 #include <hdf4cpp/HdfItem.h>
 #include <hdf4cpp/HdfAttribute.h>
 #include <hdf4cpp/HdfException.h>
+#include <hdf4cpp/HdfTypeTraits.h>
+#include <hdf4cpp/HdfAggregation.h>
+#include <hdf4cpp/HdfStatistics.h>
+#include <hdf4cpp/HdfThreadPool.h>
+#include <hdf4cpp/HdfBatch.h>
+#include <hdf4cpp/HdfScratchPool.h>
+#include <hdf4cpp/HdfHierarchy.h>
+#include <hdf4cpp/HdfMembership.h>
+#include <hdf4cpp/HdfExport.h>
+#include <hdf4cpp/HdfZarr.h>
+#include <hdf4cpp/HdfGenerator.h>
+#include <hdf4cpp/HdfDimension.h>
+#include <hdf4cpp/HdfFileLocal.h>
+#include <hdf4cpp/HdfGeolocation.h>
+#include <hdf4cpp/HdfArrayView.h>
+#include <hdf4cpp/HdfResult.h>
+#include <hdf4cpp/HdfMemoryBudget.h>
+#include <hdf4cpp/HdfAllocator.h>
+#include <hdf4cpp/HdfPyramid.h>
+#include <hdf4cpp/HdfLayout.h>
+#include <hdf4cpp/HdfChecksum.h>
+#include <hdf4cpp/HdfDiff.h>
 
 
 #endif //HDF4CPP_HDF_H
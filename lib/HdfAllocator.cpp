@@ -0,0 +1,77 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfAllocator.h>
+#include <hdf4cpp/HdfThreadPool.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+/// Writes the buffer first from the threads of a pool shared by every allocation,
+/// every thread zeroes a contiguous part of it
+void touchFirst(void *pointer, size_t bytes) {
+    // started at the first use, so the threads are not started again for every allocation
+    static hdf4cpp::HdfThreadPool pool;
+    size_t parts = pool.size();
+    std::vector<std::future<void>> futures;
+    for (size_t part = 0; part < parts; ++part) {
+        // the parts begin at page boundaries, so a page is touched by one thread
+        size_t begin = (bytes * part / parts) & ~(size_t)4095;
+        size_t end = (part + 1 == parts) ? bytes : ((bytes * (part + 1) / parts) & ~(size_t)4095);
+        uint8 *data = static_cast<uint8 *>(pointer);
+        futures.push_back(pool.submit([data, begin, end]() { std::memset(data + begin, 0, end - begin); }));
+    }
+    for (auto &future : futures) {
+        future.get();
+    }
+}
+}
+
+void *hdf4cpp::detail::allocateAligned(size_t bytes, size_t alignment, unsigned flags) {
+    bool large = bytes >= LARGE_BUFFER_SIZE;
+    if (alignment < sizeof(void *)) {
+        alignment = sizeof(void *);
+    }
+    void *pointer = nullptr;
+#ifdef _WIN32
+    pointer = _aligned_malloc(bytes ? bytes : 1, alignment);
+#else
+    if (large && (flags & ALLOCATION_HUGE_PAGES) && alignment < LARGE_BUFFER_SIZE) {
+        // a huge page can back only an aligned block of its size
+        alignment = LARGE_BUFFER_SIZE;
+    }
+    if (posix_memalign(&pointer, alignment, bytes ? bytes : 1)) {
+        pointer = nullptr;
+    }
+#endif
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (large && (flags & ALLOCATION_HUGE_PAGES)) {
+        // only advice, the buffer is usable without huge pages as well
+        madvise(pointer, bytes, MADV_HUGEPAGE);
+    }
+#endif
+    if (large && (flags & ALLOCATION_FIRST_TOUCH)) {
+        touchFirst(pointer, bytes);
+    }
+    return pointer;
+}
+void hdf4cpp::detail::deallocateAligned(void *pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
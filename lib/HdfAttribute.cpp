@@ -23,36 +23,33 @@ int32 hdf4cpp::HdfAttribute::HdfDatasetAttribute::size() const {
 int32 hdf4cpp::HdfAttribute::HdfDatasetAttribute::getDataType() const {
     return dataType;
 }
-void hdf4cpp::HdfAttribute::HdfDatasetAttribute::get(void *dest) {
+hdf4cpp::HdfStatus hdf4cpp::HdfAttribute::HdfDatasetAttribute::get(void *dest) {
     int32 nrValues;
     char nameRet[MAX_NAME_LENGTH];
     int32 status = SDattrinfo(id, index, nameRet, &dataType, &nrValues);
     if (status == FAIL) {
-        raiseException(STATUS_RETURN_FAIL);
+        return error(STATUS_RETURN_FAIL);
     }
 
     if (SDreadattr(id, index, dest) == FAIL) {
-        raiseException(STATUS_RETURN_FAIL);
+        return error(STATUS_RETURN_FAIL);
     }
+    return HdfStatus();
 }
 hdf4cpp::HdfAttribute::HdfGroupAttribute::HdfGroupAttribute(int32 id,
                                                             const std::string &name,
                                                             const HdfDestroyerChain &chain)
     : HdfAttributeBase(id, 0, VGROUP, chain) {
-    intn nrAtts = Vnattrs2(id);
-    for (intn i = 0; i < nrAtts; ++i) {
-        char names[MAX_NAME_LENGTH];
-        int32 type, count, size, nFields;
-        uint16 refNum;
-        Vattrinfo2(id, i, names, &type, &count, &size, &nFields, &refNum);
-        if (name == std::string(names)) {
-            index = i;
-            _size = count;
-            dataType = type;
-            return;
-        }
+    index = findIndex(id, VGROUP, name);
+    if (index == FAIL) {
+        raiseException(INVALID_NAME);
+    }
+    char names[MAX_NAME_LENGTH];
+    int32 size, nFields;
+    uint16 refNum;
+    if (Vattrinfo2(id, index, names, &dataType, &_size, &size, &nFields, &refNum) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
     }
-    raiseException(INVALID_NAME);
 }
 int32 hdf4cpp::HdfAttribute::HdfGroupAttribute::size() const {
     return _size;
@@ -60,10 +57,11 @@ int32 hdf4cpp::HdfAttribute::HdfGroupAttribute::size() const {
 int32 hdf4cpp::HdfAttribute::HdfGroupAttribute::getDataType() const {
     return dataType;
 }
-void hdf4cpp::HdfAttribute::HdfGroupAttribute::get(void *dest) {
+hdf4cpp::HdfStatus hdf4cpp::HdfAttribute::HdfGroupAttribute::get(void *dest) {
     if (Vgetattr2(id, index, dest) == FAIL) {
-        raiseException(STATUS_RETURN_FAIL);
+        return error(STATUS_RETURN_FAIL);
     }
+    return HdfStatus();
 }
 hdf4cpp::HdfAttribute::HdfDataAttribute::HdfDataAttribute(int32 id,
                                                           const std::string &name,
@@ -76,20 +74,44 @@ hdf4cpp::HdfAttribute::HdfDataAttribute::HdfDataAttribute(int32 id,
 int32 hdf4cpp::HdfAttribute::HdfDataAttribute::size() const {
     return _size;
 }
-void hdf4cpp::HdfAttribute::HdfDataAttribute::get(void *dest) {
+hdf4cpp::HdfStatus hdf4cpp::HdfAttribute::HdfDataAttribute::get(void *dest) {
     if (VSgetattr(id, _HDF_VDATA, index, dest) == FAIL) {
-        raiseException(STATUS_RETURN_FAIL);
+        return error(STATUS_RETURN_FAIL);
     }
+    return HdfStatus();
 }
 int32 hdf4cpp::HdfAttribute::HdfDataAttribute::getDataType() const {
     return dataType;
 }
+hdf4cpp::HdfAttribute::HdfImageAttribute::HdfImageAttribute(int32 id,
+                                                            const std::string &name,
+                                                            const HdfDestroyerChain &chain)
+    : HdfAttributeBase(id, GRfindattr(id, name.c_str()), GRIMAGE, chain) {
+    char waste[MAX_NAME_LENGTH];
+    if (GRattrinfo(id, index, waste, &dataType, &_size) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+}
+int32 hdf4cpp::HdfAttribute::HdfImageAttribute::size() const {
+    return _size;
+}
+hdf4cpp::HdfStatus hdf4cpp::HdfAttribute::HdfImageAttribute::get(void *dest) {
+    if (GRgetattr(id, index, dest) == FAIL) {
+        return error(STATUS_RETURN_FAIL);
+    }
+    return HdfStatus();
+}
+int32 hdf4cpp::HdfAttribute::HdfImageAttribute::getDataType() const {
+    return dataType;
+}
 hdf4cpp::HdfAttribute::HdfAttribute(HdfAttribute &&other) noexcept
     : HdfObject(other.getType(), other.getClassType(), std::move(other.chain))
-    , attribute(std::move(other.attribute)) {
+    , attribute(std::move(other.attribute))
+    , budget(std::move(other.budget)) {
 }
 hdf4cpp::HdfAttribute &hdf4cpp::HdfAttribute::operator=(HdfAttribute &&other) noexcept {
     attribute = std::move(other.attribute);
+    budget = std::move(other.budget);
     setType(attribute->getType());
     setClassType(attribute->getClassType());
     return *this;
@@ -104,6 +126,62 @@ HdfAttribute::HdfAttribute(HdfAttributeBase *attribute)
 int32 HdfAttribute::getDataType() const {
     return attribute->getDataType();
 }
-void HdfAttribute::getInternal(void *dest) {
-    attribute->get(dest);
+HdfStatus HdfAttribute::getInternal(void *dest) {
+    return attribute->get(dest);
+}
+int32 HdfAttribute::findIndex(int32 id, Type type, const std::string &name) {
+    switch (type) {
+    case SDATA:
+        return SDfindattr(id, name.c_str());
+    case VGROUP: {
+        intn nrAtts = Vnattrs2(id);
+        for (intn i = 0; i < nrAtts; ++i) {
+            char names[MAX_NAME_LENGTH];
+            int32 dataType, count, size, nFields;
+            uint16 refNum;
+            if (Vattrinfo2(id, i, names, &dataType, &count, &size, &nFields, &refNum) != FAIL &&
+                name == std::string(names)) {
+                return i;
+            }
+        }
+        return FAIL;
+    }
+    case VDATA:
+        return VSfindattr(id, _HDF_VDATA, name.c_str());
+    case GRIMAGE:
+        return GRfindattr(id, name.c_str());
+    default:
+        return FAIL;
+    }
+}
+HdfResult<HdfAttribute> HdfAttribute::tryOpen(int32 id,
+                                               Type type,
+                                               const std::string &name,
+                                               const HdfDestroyerChain &chain,
+                                               const std::shared_ptr<HdfMemoryBudget> &budget) {
+    // the missing attribute is found out before anything is thrown, the constructors fail only on hdf errors
+    if (id == FAIL || findIndex(id, type, name) == FAIL) {
+        return HdfError{type, ATTRIBUTE, (type == VGROUP && id != FAIL) ? INVALID_NAME : INVALID_ID};
+    }
+    try {
+        HdfAttributeBase *attribute;
+        switch (type) {
+        case SDATA:
+            attribute = new HdfDatasetAttribute(id, name, chain);
+            break;
+        case VGROUP:
+            attribute = new HdfGroupAttribute(id, name, chain);
+            break;
+        case VDATA:
+            attribute = new HdfDataAttribute(id, name, chain);
+            break;
+        default:
+            attribute = new HdfImageAttribute(id, name, chain);
+        }
+        HdfAttribute result(attribute);
+        result.budget = budget;
+        return HdfResult<HdfAttribute>(std::move(result));
+    } catch (const HdfException &exception) {
+        return HdfError{exception.getType(), exception.getClassType(), exception.getExceptionType()};
+    }
 }
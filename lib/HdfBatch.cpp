@@ -0,0 +1,59 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfBatch.h>
+
+#include <numeric>
+
+hdf4cpp::HdfReadPlan hdf4cpp::planCoalescedReads(const std::vector<HdfBox> &requests, float64 maxWaste) {
+    struct Group {
+        HdfBox box;
+        size_t requested;
+        std::vector<size_t> members;
+    };
+
+    std::vector<size_t> order(requests.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return requests[a].begin < requests[b].begin; });
+
+    std::vector<Group> groups;
+    for (const auto &index : order) {
+        groups.push_back(Group{requests[index], requests[index].volume(), {index}});
+    }
+
+    // merge until there is nothing to merge, a merge can make the united box reach other groups
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < groups.size(); ++i) {
+            for (size_t j = i + 1; j < groups.size();) {
+                HdfBox united = groups[i].box.unite(groups[j].box);
+                size_t requested = groups[i].requested + groups[j].requested;
+                if (united.volume() <= maxWaste * requested) {
+                    groups[i].box = united;
+                    groups[i].requested = requested;
+                    groups[i].members.insert(groups[i].members.end(),
+                                             groups[j].members.begin(),
+                                             groups[j].members.end());
+                    groups.erase(groups.begin() + j);
+                    merged = true;
+                } else {
+                    ++j;
+                }
+            }
+        }
+    }
+
+    std::sort(groups.begin(), groups.end(), [](const Group &a, const Group &b) { return a.box.begin < b.box.begin; });
+
+    HdfReadPlan plan;
+    plan.readOf.resize(requests.size());
+    for (size_t i = 0; i < groups.size(); ++i) {
+        plan.reads.push_back(groups[i].box);
+        for (const auto &member : groups[i].members) {
+            plan.readOf[member] = i;
+        }
+    }
+    return plan;
+}
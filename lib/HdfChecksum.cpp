@@ -0,0 +1,224 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfChecksum.h>
+#include <hdf4cpp/HdfHierarchy.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+namespace {
+const std::uint64_t PRIME1 = 11400714785074694791ULL;
+const std::uint64_t PRIME2 = 14029467366897019727ULL;
+const std::uint64_t PRIME3 = 1609587929392839161ULL;
+const std::uint64_t PRIME4 = 9650029242287828579ULL;
+const std::uint64_t PRIME5 = 2870177450012600261ULL;
+
+bool isLittleEndian() {
+    const uint16 one = 1;
+    return *reinterpret_cast<const uint8 *>(&one) == 1;
+}
+
+/// Reads an unsigned integer stored in little endian byte order
+template <class T> T readLittleEndian(const uint8 *data) {
+    T value;
+    if (isLittleEndian()) {
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+    value = 0;
+    for (size_t i = sizeof(T); i-- > 0;) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+std::uint64_t rotateLeft(std::uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+std::uint64_t hashRound(std::uint64_t accumulator, std::uint64_t input) {
+    accumulator += input * PRIME2;
+    return rotateLeft(accumulator, 31) * PRIME1;
+}
+
+std::uint64_t mergeRound(std::uint64_t hash, std::uint64_t accumulator) {
+    hash ^= hashRound(0, accumulator);
+    return hash * PRIME1 + PRIME4;
+}
+
+const char *typeName(hdf4cpp::Type type) {
+    return type == hdf4cpp::SDATA ? "SDATA" : "VDATA";
+}
+}
+
+hdf4cpp::HdfHash64::HdfHash64(std::uint64_t seed)
+    : seed(seed)
+    , accumulators{seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1} {
+}
+void hdf4cpp::HdfHash64::update(const void *data, size_t size) {
+    const uint8 *bytes = static_cast<const uint8 *>(data);
+    length += size;
+    if (buffered + size < sizeof(buffer)) {
+        std::memcpy(buffer + buffered, bytes, size);
+        buffered += size;
+        return;
+    }
+    if (buffered) {
+        size_t missing = sizeof(buffer) - buffered;
+        std::memcpy(buffer + buffered, bytes, missing);
+        for (size_t i = 0; i < 4; ++i) {
+            accumulators[i] = hashRound(accumulators[i], readLittleEndian<std::uint64_t>(buffer + 8 * i));
+        }
+        bytes += missing;
+        size -= missing;
+        buffered = 0;
+    }
+    // the four lanes are independent, so the compiler can keep them in flight together
+    std::uint64_t v1 = accumulators[0], v2 = accumulators[1], v3 = accumulators[2], v4 = accumulators[3];
+    for (; size >= sizeof(buffer); bytes += sizeof(buffer), size -= sizeof(buffer)) {
+        v1 = hashRound(v1, readLittleEndian<std::uint64_t>(bytes));
+        v2 = hashRound(v2, readLittleEndian<std::uint64_t>(bytes + 8));
+        v3 = hashRound(v3, readLittleEndian<std::uint64_t>(bytes + 16));
+        v4 = hashRound(v4, readLittleEndian<std::uint64_t>(bytes + 24));
+    }
+    accumulators[0] = v1;
+    accumulators[1] = v2;
+    accumulators[2] = v3;
+    accumulators[3] = v4;
+    std::memcpy(buffer, bytes, size);
+    buffered = size;
+}
+std::uint64_t hdf4cpp::HdfHash64::digest() const {
+    std::uint64_t hash;
+    if (length >= sizeof(buffer)) {
+        hash = rotateLeft(accumulators[0], 1) + rotateLeft(accumulators[1], 7) + rotateLeft(accumulators[2], 12) +
+               rotateLeft(accumulators[3], 18);
+        for (size_t i = 0; i < 4; ++i) {
+            hash = mergeRound(hash, accumulators[i]);
+        }
+    } else {
+        hash = seed + PRIME5;
+    }
+    hash += length;
+
+    size_t i = 0;
+    for (; i + 8 <= buffered; i += 8) {
+        hash ^= hashRound(0, readLittleEndian<std::uint64_t>(buffer + i));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (i + 4 <= buffered) {
+        hash ^= (std::uint64_t)readLittleEndian<std::uint32_t>(buffer + i) * PRIME1;
+        hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+        i += 4;
+    }
+    for (; i < buffered; ++i) {
+        hash ^= buffer[i] * PRIME5;
+        hash = rotateLeft(hash, 11) * PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::string hdf4cpp::HdfChecksumManifest::toString() const {
+    std::ostringstream text;
+    text << std::hex << std::setfill('0');
+    for (const auto &item : items) {
+        text << std::setw(16) << item.digest << ' ' << typeName(item.type) << ' ' << std::dec << item.size << ' '
+             << item.path << '\n'
+             << std::hex;
+    }
+    text << std::setw(16) << digest << " FILE\n";
+    return text.str();
+}
+
+/// Queues the hashing of the bands of an item, instantiated once per number type
+struct hdf4cpp::HdfChecksummer::BandHasher {
+    HdfChecksummer *checksummer;
+    std::shared_ptr<HdfHash64> hash;
+    std::uint64_t &size;
+
+    template <class T> void operator()(std::vector<T> &band, int32) {
+        std::shared_ptr<std::vector<T>> data = std::make_shared<std::vector<T>>(std::move(band));
+        size += data->size() * sizeof(T);
+        std::shared_ptr<HdfHash64> state = hash;
+        // the pool has one worker, so the bands are hashed in order
+        checksummer->window.submit([state, data]() { state->update(data->data(), data->size() * sizeof(T)); });
+    }
+};
+
+hdf4cpp::HdfChecksummer::HdfChecksummer(const HdfChecksumOptions &options)
+    : HdfObject(HFILE, FILE)
+    , options(options)
+    , pool(1)
+    , window(pool, 2) {
+}
+hdf4cpp::HdfChecksum hdf4cpp::HdfChecksummer::checksum(HdfItem &item) {
+    HdfChecksum checksum{item.getPath(), item.getType(), 0, 0};
+    std::shared_ptr<HdfHash64> hash = std::make_shared<HdfHash64>(options.seed);
+    std::vector<int32> header{(int32)item.getType()};
+    BandHasher hasher{this, hash, checksum.size};
+    switch (item.getType()) {
+    case SDATA: {
+        std::vector<int32> dims = item.getDims();
+        header.push_back(item.getDataType());
+        header.push_back((int32)dims.size());
+        header.insert(header.end(), dims.begin(), dims.end());
+        hash->update(header.data(), header.size() * sizeof(int32));
+        item.readAnyBands(hasher, options.bandSize);
+        break;
+    }
+    case VDATA: {
+        HdfRecordLayout layout = item.getRecordLayout();
+        header.push_back(layout.recordCount);
+        header.push_back(layout.recordSize);
+        header.push_back((int32)layout.fields.size());
+        hash->update(header.data(), header.size() * sizeof(int32));
+        for (const auto &field : layout.fields) {
+            // the terminating zero separates the name from the type
+            hash->update(field.name.c_str(), field.name.size() + 1);
+            int32 type[2] = {field.dataType, field.order};
+            hash->update(type, sizeof(type));
+        }
+        item.readRecordBatches(hasher, options.bandSize);
+        break;
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+    window.wait();
+    checksum.digest = hash->digest();
+    return checksum;
+}
+hdf4cpp::HdfChecksumManifest hdf4cpp::HdfChecksummer::checksumFile(const HdfFile &file) {
+    HdfChecksumManifest manifest;
+    HdfHierarchy hierarchy(file);
+    for (size_t i = 0; i < hierarchy.size(); ++i) {
+        const HdfItemRef &ref = hierarchy.getNode(i).ref;
+        if (ref.getType() == SDATA || ref.getType() == VDATA) {
+            HdfItem item = ref.get();
+            manifest.items.push_back(checksum(item));
+        }
+    }
+    std::sort(manifest.items.begin(), manifest.items.end(), [](const HdfChecksum &a, const HdfChecksum &b) {
+        return a.path != b.path ? a.path < b.path : a.digest < b.digest;
+    });
+
+    HdfHash64 hash(options.seed);
+    for (const auto &item : manifest.items) {
+        // the terminating zero separates the path from the digest
+        hash.update(item.path.c_str(), item.path.size() + 1);
+        hash.update(&item.digest, sizeof(item.digest));
+    }
+    manifest.digest = hash.digest();
+    return manifest;
+}
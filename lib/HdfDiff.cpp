@@ -0,0 +1,369 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfAttribute.h>
+#include <hdf4cpp/HdfDiff.h>
+#include <hdf4cpp/HdfHierarchy.h>
+#include <hdf4cpp/HdfTypeTraits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <sstream>
+
+namespace {
+const char *typeName(hdf4cpp::Type type) {
+    switch (type) {
+    case hdf4cpp::SDATA:
+        return "SData";
+    case hdf4cpp::VGROUP:
+        return "VGroup";
+    case hdf4cpp::VDATA:
+        return "VData";
+    case hdf4cpp::GRIMAGE:
+        return "GR image";
+    default:
+        return "file";
+    }
+}
+
+std::string dimsToString(const std::vector<int32> &dims) {
+    std::ostringstream text;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        text << (i ? "x" : "") << dims[i];
+    }
+    return text.str();
+}
+
+template <class T> void addDifference(std::vector<std::string> &differences, const std::string &what, T first, T second) {
+    if (first != second) {
+        std::ostringstream text;
+        text << what << ' ' << first << " != " << second;
+        differences.push_back(text.str());
+    }
+}
+
+/// Compares the fields of two records in their order in the records
+void compareFields(const std::vector<hdf4cpp::HdfRecordField> &first,
+                   const std::vector<hdf4cpp::HdfRecordField> &second,
+                   std::vector<std::string> &differences) {
+    addDifference(differences, "field count", first.size(), second.size());
+    for (size_t i = 0; i < std::min(first.size(), second.size()); ++i) {
+        std::string what = "field " + std::to_string(i);
+        addDifference(differences, what + " name", first[i].name, second[i].name);
+        addDifference(differences, what + " data type", first[i].dataType, second[i].dataType);
+        addDifference(differences, what + " order", first[i].order, second[i].order);
+    }
+}
+
+/// Decides whether two values differ, NaNs are equal to each other
+struct ValueComparer {
+    float64 tolerance;
+    float64 relativeTolerance;
+
+    template <class T> bool exactlyDiffers(T first, T second) const {
+        return !(first == second) && !(first != first && second != second);
+    }
+    bool differs(float64 first, float64 second) const {
+        float64 limit = tolerance + relativeTolerance * std::max(std::fabs(first), std::fabs(second));
+        return !(first == second || std::fabs(first - second) <= limit || (first != first && second != second));
+    }
+};
+
+/// Compares two bands of values and adds the result to the statistics
+template <class T>
+void compareValues(const T *first,
+                   const T *second,
+                   size_t size,
+                   const hdf4cpp::HdfDiffOptions &options,
+                   hdf4cpp::HdfItemDiff &result) {
+    ValueComparer comparer{options.tolerance, options.relativeTolerance};
+    bool exact = options.tolerance == 0.0 && options.relativeTolerance == 0.0;
+    std::uint64_t differing = 0;
+    float64 maxAbsDiff = 0.0;
+    bool nanMismatch = false;
+    // the loops have no early exit, so the compiler can vectorize them
+    if (exact) {
+        for (size_t i = 0; i < size; ++i) {
+            differing += comparer.exactlyDiffers(first[i], second[i]);
+        }
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            differing += comparer.differs((float64)first[i], (float64)second[i]);
+        }
+    }
+    // the largest difference is accumulated in every band, the values within the tolerances included
+    for (size_t i = 0; i < size; ++i) {
+        float64 a = (float64)first[i], b = (float64)second[i];
+        float64 diff = a == b ? 0.0 : std::fabs(a - b);
+        nanMismatch |= (a != a) != (b != b);
+        maxAbsDiff = diff > maxAbsDiff ? diff : maxAbsDiff;
+    }
+    if (differing && !result.differing) {
+        size_t index = 0;
+        while (exact ? !comparer.exactlyDiffers(first[index], second[index])
+                     : !comparer.differs((float64)first[index], (float64)second[index])) {
+            ++index;
+        }
+        result.firstDifference = result.compared + index;
+    }
+    result.compared += size;
+    result.differing += differing;
+    if (nanMismatch || result.maxAbsDiff != result.maxAbsDiff) {
+        result.maxAbsDiff = std::numeric_limits<float64>::quiet_NaN();
+    } else {
+        result.maxAbsDiff = std::max(result.maxAbsDiff, maxAbsDiff);
+    }
+}
+
+/// Reads the values of an attribute as bytes, instantiated once per number type
+struct AttributeReader {
+    hdf4cpp::HdfAttribute &attribute;
+    std::vector<uint8> &bytes;
+
+    template <class T> void operator()(hdf4cpp::HdfTypeTag<T>) {
+        std::vector<T> values;
+        attribute.get(values);
+        const uint8 *data = reinterpret_cast<const uint8 *>(values.data());
+        bytes.assign(data, data + values.size() * sizeof(T));
+    }
+};
+
+/// The items of a file by type and path, in the order of the hierarchy
+typedef std::map<std::pair<hdf4cpp::Type, std::string>, std::vector<size_t>> ItemIndex;
+
+ItemIndex indexItems(const hdf4cpp::HdfHierarchy &hierarchy) {
+    ItemIndex index;
+    for (size_t i = 0; i < hierarchy.size(); ++i) {
+        const hdf4cpp::HdfItemRef &ref = hierarchy.getNode(i).ref;
+        hdf4cpp::HdfItem item = ref.get();
+        index[std::make_pair(ref.getType(), item.getPath())].push_back(i);
+    }
+    return index;
+}
+}
+
+/// Compares the data of two SData items band by band, instantiated once per number type
+struct hdf4cpp::HdfDiffer::BandComparer {
+    const HdfDiffOptions &options;
+    HdfItem &first;
+    HdfItem &second;
+    const std::vector<int32> &dims;
+    HdfItemDiff &result;
+
+    template <class T> void operator()(HdfTypeTag<T>) {
+        size_t rowSize = sizeof(T);
+        for (size_t i = 1; i < dims.size(); ++i) {
+            rowSize *= (size_t)std::max<int32>(1, dims[i]);
+        }
+        int32 bandRows = (int32)std::max<size_t>(
+        1, std::min<size_t>(options.bandSize / rowSize, (size_t)std::numeric_limits<int32>::max()));
+        std::vector<Range> ranges;
+        Range::fill(ranges, dims);
+        std::vector<T> firstBand, secondBand;
+        for (int32 row = 0; row < dims[0]; row += ranges[0].quantity) {
+            ranges[0] = Range(row, std::min(bandRows, dims[0] - row));
+            first.read(firstBand, ranges);
+            second.read(secondBand, ranges);
+            compareValues(firstBand.data(), secondBand.data(), firstBand.size(), options, result);
+            if (options.stopAtFirst && result.differing) {
+                return;
+            }
+        }
+    }
+};
+
+std::string hdf4cpp::HdfFileDiff::toString() const {
+    std::ostringstream text;
+    for (const auto &path : onlyInFirst) {
+        text << "only in the first file: " << path << '\n';
+    }
+    for (const auto &path : onlyInSecond) {
+        text << "only in the second file: " << path << '\n';
+    }
+    for (const auto &item : items) {
+        for (const auto &difference : item.differences) {
+            text << typeName(item.type) << ' ' << item.path << ": " << difference << '\n';
+        }
+        if (item.differing) {
+            text << typeName(item.type) << ' ' << item.path << ": " << item.differing << " of " << item.compared
+                 << (item.type == VDATA ? " records" : " values") << " differ, the first at " << item.firstDifference;
+            if (item.type == SDATA) {
+                text << ", max abs diff " << item.maxAbsDiff;
+            }
+            text << '\n';
+        }
+    }
+    text << compared << " items compared, " << items.size() << " differ\n";
+    return text.str();
+}
+
+hdf4cpp::HdfDiffer::HdfDiffer(const HdfDiffOptions &options)
+    : HdfObject(HFILE, FILE)
+    , options(options) {
+}
+hdf4cpp::HdfItemDiff hdf4cpp::HdfDiffer::diff(HdfItem &first, HdfItem &second) const {
+    HdfItemDiff result;
+    result.path = first.getPath();
+    result.type = first.getType();
+    if (first.getType() != second.getType()) {
+        result.differences.push_back(std::string("type ") + typeName(first.getType()) + " != " +
+                                     typeName(second.getType()));
+        return result;
+    }
+    switch (first.getType()) {
+    case SDATA: {
+        std::vector<int32> firstDims = first.getDims();
+        std::vector<int32> secondDims = second.getDims();
+        addDifference(result.differences, "data type", first.getDataType(), second.getDataType());
+        addDifference(result.differences, "dimensions", dimsToString(firstDims), dimsToString(secondDims));
+        if (result.differences.empty()) {
+            compareDatasets(first, second, result);
+        }
+        break;
+    }
+    case VDATA: {
+        HdfRecordLayout firstLayout = first.getRecordLayout();
+        HdfRecordLayout secondLayout = second.getRecordLayout();
+        addDifference(result.differences, "record count", firstLayout.recordCount, secondLayout.recordCount);
+        addDifference(result.differences, "record size", firstLayout.recordSize, secondLayout.recordSize);
+        addDifference(result.differences, "interlace", firstLayout.interlace, secondLayout.interlace);
+        compareFields(firstLayout.fields, secondLayout.fields, result.differences);
+        if (result.differences.empty()) {
+            compareRecords(first, second, result);
+        }
+        break;
+    }
+    case GRIMAGE: {
+        addDifference(result.differences, "data type", first.getDataType(), second.getDataType());
+        addDifference(result.differences, "dimensions", dimsToString(first.getDims()), dimsToString(second.getDims()));
+        addDifference(result.differences, "components", first.getComponentCount(), second.getComponentCount());
+        break;
+    }
+    default:
+        break;
+    }
+    if (options.compareAttributes && !(options.stopAtFirst && !result.equal())) {
+        compareAttributes(first, second, result.differences);
+    }
+    return result;
+}
+hdf4cpp::HdfFileDiff hdf4cpp::HdfDiffer::diff(const HdfFile &first, const HdfFile &second) const {
+    HdfFileDiff result;
+    HdfHierarchy firstHierarchy(first);
+    HdfHierarchy secondHierarchy(second);
+    ItemIndex firstItems = indexItems(firstHierarchy);
+    ItemIndex secondItems = indexItems(secondHierarchy);
+    for (const auto &entry : firstItems) {
+        auto found = secondItems.find(entry.first);
+        size_t matched = found == secondItems.end() ? 0 : std::min(entry.second.size(), found->second.size());
+        for (size_t i = 0; i < entry.second.size(); ++i) {
+            if (options.stopAtFirst && !result.equal()) {
+                return result;
+            }
+            if (i >= matched) {
+                result.onlyInFirst.push_back(entry.first.second);
+                continue;
+            }
+            HdfItem firstItem = firstHierarchy.getNode(entry.second[i]).ref.get();
+            HdfItem secondItem = secondHierarchy.getNode(found->second[i]).ref.get();
+            HdfItemDiff itemDiff = diff(firstItem, secondItem);
+            ++result.compared;
+            if (!itemDiff.equal()) {
+                result.items.push_back(itemDiff);
+            }
+        }
+    }
+    for (const auto &entry : secondItems) {
+        auto found = firstItems.find(entry.first);
+        size_t matched = found == firstItems.end() ? 0 : std::min(entry.second.size(), found->second.size());
+        for (size_t i = matched; i < entry.second.size(); ++i) {
+            result.onlyInSecond.push_back(entry.first.second);
+        }
+    }
+    return result;
+}
+void hdf4cpp::HdfDiffer::compareAttributes(const HdfItem &first,
+                                           const HdfItem &second,
+                                           std::vector<std::string> &differences) const {
+    std::vector<std::string> firstNames = first.getAttributeNames();
+    std::vector<std::string> secondNames = second.getAttributeNames();
+    std::sort(firstNames.begin(), firstNames.end());
+    std::sort(secondNames.begin(), secondNames.end());
+    std::vector<std::string> common;
+    std::set_intersection(firstNames.begin(),
+                          firstNames.end(),
+                          secondNames.begin(),
+                          secondNames.end(),
+                          std::back_inserter(common));
+    for (const auto &name : firstNames) {
+        if (!std::binary_search(common.begin(), common.end(), name)) {
+            differences.push_back("attribute " + name + " only in the first");
+        }
+    }
+    for (const auto &name : secondNames) {
+        if (!std::binary_search(common.begin(), common.end(), name)) {
+            differences.push_back("attribute " + name + " only in the second");
+        }
+    }
+    for (const auto &name : common) {
+        HdfAttribute firstAttribute = first.getAttribute(name);
+        HdfAttribute secondAttribute = second.getAttribute(name);
+        if (firstAttribute.getDataType() != secondAttribute.getDataType() ||
+            firstAttribute.size() != secondAttribute.size()) {
+            differences.push_back("attribute " + name + " type or size");
+            continue;
+        }
+        std::vector<uint8> firstBytes, secondBytes;
+        AttributeReader firstReader{firstAttribute, firstBytes};
+        AttributeReader secondReader{secondAttribute, secondBytes};
+        if (dispatchNumberType(firstAttribute.getDataType(), firstReader) &&
+            dispatchNumberType(secondAttribute.getDataType(), secondReader) && firstBytes != secondBytes) {
+            differences.push_back("attribute " + name + " values");
+        }
+    }
+}
+void hdf4cpp::HdfDiffer::compareDatasets(HdfItem &first, HdfItem &second, HdfItemDiff &result) const {
+    std::vector<int32> dims = first.getDims();
+    if (dims.empty() || !dims[0]) {
+        return;
+    }
+    BandComparer comparer{options, first, second, dims, result};
+    if (!dispatchNumberType(first.getDataType(), comparer)) {
+        raiseException(INVALID_DATA_TYPE);
+    }
+}
+void hdf4cpp::HdfDiffer::compareRecords(HdfItem &first, HdfItem &second, HdfItemDiff &result) const {
+    HdfRecordLayout layout = first.getRecordLayout();
+    size_t recordSize = (size_t)std::max<int32>(1, layout.recordSize);
+    int32 batch = (int32)std::max<size_t>(
+    1, std::min<size_t>(options.bandSize / recordSize, (size_t)std::numeric_limits<int32>::max()));
+    std::vector<uint8> firstBatch, secondBatch;
+    for (int32 record = 0; record < layout.recordCount;) {
+        int32 count = std::min(batch, layout.recordCount - record);
+        first.readRecords(firstBatch, count, record);
+        second.readRecords(secondBatch, count, record);
+        if (firstBatch.size() != secondBatch.size()) {
+            result.differences.push_back("packed record size");
+            return;
+        }
+        size_t size = firstBatch.size() / count;
+        for (int32 i = 0; i < count; ++i) {
+            if (std::memcmp(firstBatch.data() + i * size, secondBatch.data() + i * size, size)) {
+                if (!result.differing) {
+                    result.firstDifference = (std::uint64_t)record + i;
+                }
+                ++result.differing;
+            }
+        }
+        result.compared += (std::uint64_t)count;
+        record += count;
+        if (options.stopAtFirst && result.differing) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,242 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfDimension.h>
+#include <hdf4cpp/HdfFileLocal.h>
+#include <hdf4cpp/HdfTypeTraits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mfhdf.h>
+#include <mutex>
+#include <numeric>
+
+struct hdf4cpp::HdfDimension::Scale {
+    std::mutex mutex;
+    bool loaded = false;
+    std::vector<uint8> data;
+    std::unique_ptr<HdfCoordinateIndex> index;
+};
+
+namespace {
+/// Orders the values increasingly, the NaNs are the last ones
+bool lessWithNaN(float64 a, float64 b) {
+    return !std::isnan(a) && (std::isnan(b) || a < b);
+}
+
+/// Converts the bytes of a scale to coordinate values
+struct ScaleConverter {
+    const std::vector<uint8> &data;
+    std::vector<float64> &values;
+
+    template <class T> void operator()(hdf4cpp::HdfTypeTag<T>) {
+        values.resize(data.size() / sizeof(T));
+        for (size_t i = 0; i < values.size(); ++i) {
+            T value;
+            std::memcpy(&value, data.data() + i * sizeof(T), sizeof(T));
+            values[i] = (float64)value;
+        }
+    }
+};
+
+/// The scales of the dimensions of a file by their names and sizes
+struct ScaleCache {
+    std::mutex mutex;
+    std::map<std::pair<std::string, int32>, std::shared_ptr<hdf4cpp::HdfDimension::Scale>> scales;
+};
+}
+
+hdf4cpp::HdfCoordinateIndex::HdfCoordinateIndex(std::vector<float64> values)
+    : values(std::move(values))
+    , order(INCREASING)
+    , valid(0) {
+    const std::vector<float64> &v = this->values;
+    valid = (size_t)std::count_if(v.begin(), v.end(), [](float64 value) { return !std::isnan(value); });
+    if (valid == v.size()) {
+        if (std::is_sorted(v.begin(), v.end())) {
+            order = INCREASING;
+        } else if (std::is_sorted(v.rbegin(), v.rend())) {
+            order = DECREASING;
+        } else {
+            order = UNORDERED;
+        }
+    } else {
+        order = UNORDERED;
+    }
+    if (order == UNORDERED) {
+        sorted.resize(v.size());
+        std::iota(sorted.begin(), sorted.end(), 0);
+        std::stable_sort(sorted.begin(), sorted.end(), [&v](int32 a, int32 b) { return lessWithNaN(v[a], v[b]); });
+
+        size_t blocks = (valid + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        blockBounds.emplace_back(blocks);
+        for (size_t block = 0; block < blocks; ++block) {
+            auto first = sorted.begin() + block * BLOCK_SIZE;
+            auto bounds = std::minmax_element(first, sorted.begin() + std::min(valid, (block + 1) * BLOCK_SIZE));
+            blockBounds[0][block] = std::make_pair(*bounds.first, *bounds.second);
+        }
+        for (size_t level = 1; ((size_t)1 << level) <= blocks; ++level) {
+            size_t half = (size_t)1 << (level - 1);
+            const std::vector<std::pair<int32, int32>> &previous = blockBounds[level - 1];
+            std::vector<std::pair<int32, int32>> current(blocks - 2 * half + 1);
+            for (size_t block = 0; block < current.size(); ++block) {
+                current[block] = std::make_pair(std::min(previous[block].first, previous[block + half].first),
+                                                std::max(previous[block].second, previous[block + half].second));
+            }
+            blockBounds.push_back(std::move(current));
+        }
+    }
+}
+std::pair<int32, int32> hdf4cpp::HdfCoordinateIndex::getBounds(size_t first, size_t last) const {
+    size_t firstBlock = first / BLOCK_SIZE;
+    size_t lastBlock = (last - 1) / BLOCK_SIZE;
+    if (lastBlock - firstBlock < 2) {
+        auto bounds = std::minmax_element(sorted.begin() + first, sorted.begin() + last);
+        return std::make_pair(*bounds.first, *bounds.second);
+    }
+    // the partial blocks at the ends are scanned, the whole blocks between them are covered
+    // by two overlapping runs of 2^level blocks
+    auto head = std::minmax_element(sorted.begin() + first, sorted.begin() + (firstBlock + 1) * BLOCK_SIZE);
+    auto tail = std::minmax_element(sorted.begin() + lastBlock * BLOCK_SIZE, sorted.begin() + last);
+    size_t blocks = lastBlock - firstBlock - 1;
+    size_t level = 0;
+    while (((size_t)2 << level) <= blocks) {
+        ++level;
+    }
+    const std::pair<int32, int32> &left = blockBounds[level][firstBlock + 1];
+    const std::pair<int32, int32> &right = blockBounds[level][lastBlock - ((size_t)1 << level)];
+    return std::make_pair(std::min({*head.first, *tail.first, left.first, right.first}),
+                          std::max({*head.second, *tail.second, left.second, right.second}));
+}
+hdf4cpp::Range hdf4cpp::HdfCoordinateIndex::find(const HdfInterval &interval) const {
+    if (!(interval.min <= interval.max)) {
+        return Range(0, 0);
+    }
+    switch (order) {
+    case INCREASING: {
+        auto first = std::lower_bound(values.begin(), values.end(), interval.min);
+        auto last = std::upper_bound(first, values.end(), interval.max);
+        return Range((int32)(first - values.begin()), (int32)(last - first));
+    }
+    case DECREASING: {
+        auto first = std::lower_bound(values.begin(), values.end(), interval.max, std::greater<float64>());
+        auto last = std::upper_bound(first, values.end(), interval.min, std::greater<float64>());
+        return Range((int32)(first - values.begin()), (int32)(last - first));
+    }
+    default: {
+        const std::vector<float64> &v = values;
+        auto end = sorted.begin() + valid;
+        auto first = std::lower_bound(
+            sorted.begin(), end, interval.min, [&v](int32 index, float64 value) { return v[index] < value; });
+        auto last =
+            std::upper_bound(first, end, interval.max, [&v](float64 value, int32 index) { return value < v[index]; });
+        if (first == last) {
+            return Range(0, 0);
+        }
+        std::pair<int32, int32> bounds = getBounds(first - sorted.begin(), last - sorted.begin());
+        return Range(bounds.first, bounds.second - bounds.first + 1);
+    }
+    }
+}
+bool hdf4cpp::HdfCoordinateIndex::isMonotonic() const {
+    return order != UNORDERED;
+}
+
+hdf4cpp::HdfDimension::HdfDimension(int32 sId,
+                                    int32 id,
+                                    const std::string &name,
+                                    int32 size,
+                                    bool unlimited,
+                                    int32 dataType,
+                                    const std::shared_ptr<Scale> &scale,
+                                    const HdfDestroyerChain &chain)
+    : HdfObject(SDATA, DIMENSION, chain)
+    , sId(sId)
+    , id(id)
+    , name(name)
+    , size(size)
+    , unlimited(unlimited)
+    , dataType(dataType)
+    , scale(scale) {
+}
+const std::string &hdf4cpp::HdfDimension::getName() const {
+    return name;
+}
+int32 hdf4cpp::HdfDimension::getSize() const {
+    return size;
+}
+bool hdf4cpp::HdfDimension::isUnlimited() const {
+    return unlimited;
+}
+bool hdf4cpp::HdfDimension::hasScale() const {
+    return dataType != 0;
+}
+int32 hdf4cpp::HdfDimension::getDataType() const {
+    return dataType;
+}
+const hdf4cpp::HdfCoordinateIndex &hdf4cpp::HdfDimension::getCoordinateIndex() const {
+    if (!hasScale()) {
+        raiseException(INVALID_OPERATION);
+    }
+    std::lock_guard<std::mutex> lock(scale->mutex);
+    if (!scale->index) {
+        std::vector<float64> values;
+        ScaleConverter converter{readScale(), values};
+        if (isTextNumberType(dataType) || !dispatchNumberType(dataType, converter)) {
+            raiseException(INVALID_DATA_TYPE);
+        }
+        scale->index.reset(new HdfCoordinateIndex(std::move(values)));
+    }
+    return *scale->index;
+}
+const std::vector<uint8> &hdf4cpp::HdfDimension::loadScale() const {
+    std::lock_guard<std::mutex> lock(scale->mutex);
+    return readScale();
+}
+const std::vector<uint8> &hdf4cpp::HdfDimension::readScale() const {
+    if (!scale->loaded) {
+        size_t valueSize = numberTypeSize(dataType);
+        if (!valueSize) {
+            raiseException(INVALID_DATA_TYPE);
+        }
+        size_t stored = (size_t)std::max(size, getStoredScaleSize());
+        scale->data.resize(stored * valueSize);
+        if (stored && SDgetdimscale(id, scale->data.data()) == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        scale->data.resize((size_t)size * valueSize);
+        scale->loaded = true;
+    }
+    return scale->data;
+}
+int32 hdf4cpp::HdfDimension::getStoredScaleSize() const {
+    if (!unlimited) {
+        return size;
+    }
+    // the coordinate variable is the dataset with the name of the dimension
+    int32 index = SDnametoindex(sId, name.c_str());
+    int32 variable = (index == FAIL) ? FAIL : SDselect(sId, index);
+    if (variable == FAIL) {
+        return size;
+    }
+    int32 rank, dims[MAX_DIMENSION];
+    char _name[MAX_NAME_LENGTH];
+    bool coordinate = SDiscoordvar(variable) && SDgetinfo(variable, _name, &rank, dims, nullptr, nullptr) != FAIL;
+    SDendaccess(variable);
+    return coordinate ? dims[0] : size;
+}
+std::shared_ptr<hdf4cpp::HdfDimension::Scale> hdf4cpp::HdfDimension::getSharedScale(
+int32 sId, const std::weak_ptr<const void> &token, const std::string &name, int32 size) {
+    static HdfFileLocal<ScaleCache> caches;
+    std::shared_ptr<ScaleCache> cache = caches.get(sId, token, []() { return std::make_shared<ScaleCache>(); });
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    std::shared_ptr<Scale> &scale = cache->scales[std::make_pair(name, size)];
+    if (!scale) {
+        scale = std::make_shared<Scale>();
+    }
+    return scale;
+}
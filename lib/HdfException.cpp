@@ -21,6 +21,10 @@ const std::map<hdf4cpp::ExceptionType, std::string> hdf4cpp::HdfException::excep
                  "dimension of tha data)"},
 {STATUS_RETURN_FAIL, "hdf routine failed"},
 {INVALID_DATA_TYPE, "the type of the data in the hdf item is not supported"},
+{TYPE_MISMATCH, "the type of the destination does not match the type of the data in the hdf item"},
+{WRITE_FAIL, "cannot write the output file"},
+{READ_FAIL, "cannot read the input file"},
+{OUT_OF_BUDGET, "the read does not fit into the memory budget (see HdfMemoryBudget)"},
 {OTHER, "exception thrown"},
 };
 
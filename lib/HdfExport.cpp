@@ -0,0 +1,180 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfExport.h>
+#include <hdf4cpp/HdfFile.h>
+#include <hdf4cpp/HdfTypeTraits.h>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+namespace {
+bool isLittleEndian() {
+    const uint16 one = 1;
+    return *reinterpret_cast<const uint8 *>(&one) == 1;
+}
+
+std::string escapeJson(const std::string &text) {
+    std::string escaped;
+    for (const auto &c : text) {
+        switch (c) {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+}
+
+/// Queues the writing of the bands of a dataset, instantiated once per number type
+struct hdf4cpp::HdfExporter::BandWriter {
+    HdfExporter *exporter;
+    std::string path;
+    std::streamoff offset;
+
+    template <class T> void operator()(std::vector<T> &band, int32) {
+        std::shared_ptr<std::vector<T>> data = std::make_shared<std::vector<T>>(std::move(band));
+        std::streamoff at = offset;
+        offset += (std::streamoff)(data->size() * sizeof(T));
+        HdfExporter *writer = exporter;
+        std::string output = path;
+        exporter->window.submit([writer, output, at, data]() {
+            writer->writeAt(output, at, reinterpret_cast<const char *>(data->data()), data->size() * sizeof(T));
+        });
+    }
+};
+
+std::string hdf4cpp::npyDescr(int32 dataType) {
+    std::string order = isLittleEndian() ? "<" : ">";
+    switch (basicNumberType(dataType)) {
+    case DFNT_CHAR8:
+        return "|S1";
+    case DFNT_UCHAR8:
+    case DFNT_UINT8:
+        return "|u1";
+    case DFNT_INT8:
+        return "|i1";
+    case DFNT_INT16:
+        return order + "i2";
+    case DFNT_UINT16:
+        return order + "u2";
+    case DFNT_INT32:
+        return order + "i4";
+    case DFNT_UINT32:
+        return order + "u4";
+    case DFNT_FLOAT32:
+        return order + "f4";
+    case DFNT_FLOAT64:
+        return order + "f8";
+    default:
+        return std::string();
+    }
+}
+std::string hdf4cpp::npyHeader(int32 dataType, const std::vector<int32> &shape) {
+    std::ostringstream dict;
+    dict << "{'descr': '" << npyDescr(dataType) << "', 'fortran_order': False, 'shape': (";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        dict << (i ? ", " : "") << shape[i];
+    }
+    // a tuple with one element needs a trailing comma
+    dict << (shape.size() == 1 ? ",), }" : "), }");
+    std::string text = dict.str();
+
+    // magic (6) + version (2) + header length (2), the dictionary ends with a new line
+    const size_t prefix = 10;
+    size_t length = text.size() + 1;
+    length += (64 - (prefix + length) % 64) % 64;
+    text.resize(length - 1, ' ');
+    text += '\n';
+
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header += (char)(length & 0xff);
+    header += (char)((length >> 8) & 0xff);
+    return header + text;
+}
+hdf4cpp::HdfExporter::HdfExporter(const HdfExportOptions &options)
+    : HdfObject(HFILE, FILE)
+    , options(options)
+    , pool(options.threads)
+    , window(pool, options.maxPendingBands ? options.maxPendingBands : pool.size() + 1) {
+}
+void hdf4cpp::HdfExporter::exportDataset(HdfItem &item, const std::string &path, std::vector<Range> ranges) {
+    Range::fill(ranges, item.getDims());
+    std::vector<int32> shape;
+    for (const auto &range : ranges) {
+        shape.push_back(range.size());
+    }
+    int32 dataType = item.getDataType();
+    if (npyDescr(dataType).empty()) {
+        raiseException(INVALID_DATA_TYPE);
+    }
+
+    std::string header;
+    if (options.format == EXPORT_NPY) {
+        header = npyHeader(dataType, shape);
+    } else {
+        std::ofstream descriptor(path + ".json", std::ios::trunc);
+        descriptor << "{\n  \"name\": \"" << escapeJson(item.getName()) << "\",\n  \"dtype\": \""
+                   << npyDescr(dataType) << "\",\n  \"shape\": [";
+        for (size_t i = 0; i < shape.size(); ++i) {
+            descriptor << (i ? ", " : "") << shape[i];
+        }
+        descriptor << "],\n  \"order\": \"C\"\n}\n";
+        if (!descriptor) {
+            raiseException(WRITE_FAIL);
+        }
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(header.data(), header.size());
+        if (!out) {
+            raiseException(WRITE_FAIL);
+        }
+    }
+
+    BandWriter writer{this, path, (std::streamoff)header.size()};
+    item.readAnyBands(writer, options.bandSize, ranges);
+}
+void hdf4cpp::HdfExporter::exportDatasets(const std::vector<HdfExportJob> &jobs) {
+    std::unique_ptr<HdfFile> file;
+    std::string opened;
+    for (const auto &job : jobs) {
+        if (!file || job.file != opened) {
+            file.reset();
+            file.reset(new HdfFile(job.file));
+            opened = job.file;
+        }
+        HdfItem item = file->get(job.item);
+        exportDataset(item, job.output, job.ranges);
+    }
+    wait();
+}
+void hdf4cpp::HdfExporter::wait() {
+    window.wait();
+}
+void hdf4cpp::HdfExporter::writeAt(const std::string &path,
+                                   std::streamoff offset,
+                                   const char *data,
+                                   size_t size) const {
+    // every band opens the file on its own, so the bands can be written concurrently
+    std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+    out.seekp(offset);
+    out.write(data, size);
+    if (!out) {
+        raiseException(WRITE_FAIL);
+    }
+}
@@ -10,6 +10,7 @@
 #include <hdf4cpp/HdfException.h>
 #include <hdf4cpp/HdfFile.h>
 #include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfMembership.h>
 
 
 hdf4cpp::HdfFile::HdfFile(const std::string &path)
@@ -22,10 +23,15 @@ hdf4cpp::HdfFile::HdfFile(const std::string &path)
     }
 
     Vinitialize(vId);
+    grId = GRstart(vId);
 
     chain.emplaceBack(&SDend, sId);
+    if (grId != FAIL) {
+        chain.emplaceBack(&GRend, grId);
+    }
     chain.emplaceBack(&Vfinish, vId);
     chain.emplaceBack(&Hclose, vId);
+    budget = HdfMemoryBudget::ofFile(sId, chain.getToken());
 
     int32 loneSize = Vlone(vId, nullptr, 0);
     std::vector<int32> refs((size_t)loneSize);
@@ -45,8 +51,11 @@ hdf4cpp::HdfFile::HdfFile(HdfFile &&file) noexcept
     : HdfObject(file.getType(), file.getClassType(), std::move(file.chain)) {
     sId = file.sId;
     vId = file.vId;
+    grId = file.grId;
+    budget = std::move(file.budget);
     loneRefs = std::move(file.loneRefs);
-    file.sId = file.vId = FAIL;
+    loneImagesListed = file.loneImagesListed;
+    file.sId = file.vId = file.grId = FAIL;
 }
 hdf4cpp::HdfFile &hdf4cpp::HdfFile::operator=(HdfFile &&file) noexcept {
     setType(file.getType());
@@ -54,17 +63,46 @@ hdf4cpp::HdfFile &hdf4cpp::HdfFile::operator=(HdfFile &&file) noexcept {
     chain = std::move(file.chain);
     sId = file.sId;
     vId = file.vId;
+    grId = file.grId;
+    budget = std::move(file.budget);
     loneRefs = std::move(file.loneRefs);
-    file.sId = file.vId = FAIL;
+    loneImagesListed = file.loneImagesListed;
+    file.sId = file.vId = file.grId = FAIL;
     return *this;
 }
 hdf4cpp::HdfFile::~HdfFile() = default;
+const std::vector<std::pair<int32, hdf4cpp::Type>> &hdf4cpp::HdfFile::getLoneRefs() const {
+    if (loneImagesListed) {
+        return loneRefs;
+    }
+    // the GR images which are not members of a VGroup, the membership index is built only if there are images
+    int32 images, attributes;
+    if (grId != FAIL && GRfileinfo(grId, &images, &attributes) != FAIL && images > 0) {
+        std::shared_ptr<const HdfMembershipIndex> index = HdfMembershipIndex::forFile(vId, chain.getToken());
+        for (int32 i = 0; i < images; ++i) {
+            int32 id = GRselect(grId, i);
+            if (id == FAIL) {
+                continue;
+            }
+            int32 ref = GRidtoref(id);
+            GRendaccess(id);
+            if (index->getParents(GRIMAGE, ref).empty()) {
+                loneRefs.emplace_back(ref, GRIMAGE);
+            }
+        }
+    }
+    loneImagesListed = true;
+    return loneRefs;
+}
 int32 hdf4cpp::HdfFile::getSId() const {
     return sId;
 }
 int32 hdf4cpp::HdfFile::getVId() const {
     return vId;
 }
+int32 hdf4cpp::HdfFile::getGRId() const {
+    return grId;
+}
 int32 hdf4cpp::HdfFile::getDatasetId(const std::string &name) const {
     int32 index = SDnametoindex(sId, name.c_str());
     return (index == FAIL) ? (FAIL) : (SDselect(sId, index));
@@ -77,20 +115,32 @@ int32 hdf4cpp::HdfFile::getDataId(const std::string &name) const {
     int32 ref = VSfind(vId, name.c_str());
     return (ref == 0) ? (FAIL) : (VSattach(vId, ref, "r"));
 }
+int32 hdf4cpp::HdfFile::getImageId(const std::string &name) const {
+    int32 index = (grId == FAIL) ? FAIL : GRnametoindex(grId, name.c_str());
+    return (index == FAIL) ? (FAIL) : (GRselect(grId, index));
+}
 hdf4cpp::HdfItem hdf4cpp::HdfFile::get(const std::string &name) const {
+    return std::move(tryGet(name).value());
+}
+hdf4cpp::HdfResult<hdf4cpp::HdfItem> hdf4cpp::HdfFile::tryGet(const std::string &name) const {
     int32 id = getDatasetId(name);
     if (id != FAIL) {
-        return HdfItem(new HdfItem::HdfDatasetItem(id, chain), sId, vId);
+        return HdfItem(new HdfItem::HdfDatasetItem(id, chain), sId, vId, grId, budget);
+    }
+    // GR keeps every image in an internal VGroup of the same name, so the images are looked up before the VGroups
+    id = getImageId(name);
+    if (id != FAIL) {
+        return HdfItem(new HdfItem::HdfImageItem(id, chain), sId, vId, grId, budget);
     }
     id = getGroupId(name);
     if (id != FAIL) {
-        return HdfItem(new HdfItem::HdfGroupItem(id, chain), sId, vId);
+        return HdfItem(new HdfItem::HdfGroupItem(id, chain), sId, vId, grId, budget);
     }
     id = getDataId(name);
     if (id != FAIL) {
-        return HdfItem(new HdfItem::HdfDataItem(id, chain), sId, vId);
+        return HdfItem(new HdfItem::HdfDataItem(id, chain), sId, vId, grId, budget);
     }
-    raiseException(INVALID_ID);
+    return error(INVALID_ID);
 }
 std::vector<int32> hdf4cpp::HdfFile::getDatasetIds(const std::string &name) const {
     std::vector<int32> ids;
@@ -124,42 +174,86 @@ std::vector<int32> hdf4cpp::HdfFile::getGroupDataIds(const std::string &name) co
     }
     return ids;
 }
+std::vector<int32> hdf4cpp::HdfFile::getImageIds(const std::string &name) const {
+    std::vector<int32> ids;
+    int32 images, attributes;
+    if (grId == FAIL || GRfileinfo(grId, &images, &attributes) == FAIL) {
+        return ids;
+    }
+    char nameImage[MAX_NAME_LENGTH];
+    for (int32 i = 0; i < images; ++i) {
+        int32 id = GRselect(grId, i);
+        int32 components, dataType, interlace, dims[2], nrAttributes;
+        if (id != FAIL &&
+            GRgetiminfo(id, nameImage, &components, &dataType, &interlace, dims, &nrAttributes) != FAIL &&
+            name == std::string(nameImage)) {
+            ids.push_back(id);
+        } else if (id != FAIL) {
+            GRendaccess(id);
+        }
+    }
+    return ids;
+}
 std::vector<hdf4cpp::HdfItem> hdf4cpp::HdfFile::getAll(const std::string &name) const {
     const std::vector<int32> &dataset_ids = getDatasetIds(name);
     const std::vector<int32> &group_ids = getGroupDataIds(name);
+    const std::vector<int32> &image_ids = getImageIds(name);
     std::vector<HdfItem> items;
-    items.reserve(dataset_ids.size() + group_ids.size());
+    items.reserve(dataset_ids.size() + group_ids.size() + image_ids.size());
     for (auto &id : dataset_ids) {
-        items.push_back(HdfItem(new HdfItem::HdfDatasetItem(id, chain), sId, vId));
+        items.push_back(HdfItem(new HdfItem::HdfDatasetItem(id, chain), sId, vId, grId, budget));
     }
     for (auto &id : group_ids) {
-        items.push_back(HdfItem(new HdfItem::HdfGroupItem(id, chain), sId, vId));
+        items.push_back(HdfItem(new HdfItem::HdfGroupItem(id, chain), sId, vId, grId, budget));
+    }
+    for (auto &id : image_ids) {
+        items.push_back(HdfItem(new HdfItem::HdfImageItem(id, chain), sId, vId, grId, budget));
     }
     return items;
 }
 hdf4cpp::HdfAttribute hdf4cpp::HdfFile::getAttribute(const std::string &name) const {
-    return HdfAttribute(new HdfAttribute::HdfDatasetAttribute(sId, name, chain));
+    return std::move(tryGetAttribute(name).value());
+}
+hdf4cpp::HdfResult<hdf4cpp::HdfAttribute> hdf4cpp::HdfFile::tryGetAttribute(const std::string &name) const {
+    return HdfAttribute::tryOpen(sId, SDATA, name, chain, budget);
+}
+hdf4cpp::HdfMemoryBudget &hdf4cpp::HdfFile::getMemoryBudget() const {
+    return *budget;
 }
 hdf4cpp::HdfFile::Iterator hdf4cpp::HdfFile::begin() const {
     return Iterator(this, 0, chain);
 }
 hdf4cpp::HdfFile::Iterator hdf4cpp::HdfFile::end() const {
-    return Iterator(this, (int32)loneRefs.size(), chain);
+    return Iterator(this, (int32)getLoneRefs().size(), chain);
 }
 hdf4cpp::HdfItem hdf4cpp::HdfFile::Iterator::operator*() {
-    if (index < 0 || index >= (int)file->loneRefs.size()) {
+    const std::vector<std::pair<int32, Type>> &loneRefs = file->getLoneRefs();
+    if (index < 0 || index >= (int)loneRefs.size()) {
         raiseException(OUT_OF_RANGE);
     }
-    int32 ref = file->loneRefs[index].first;
-    switch (file->loneRefs[index].second) {
+    int32 ref = loneRefs[index].first;
+    switch (loneRefs[index].second) {
     case VGROUP: {
         int32 id = Vattach(file->vId, ref, "r");
-        return HdfItem(new HdfItem::HdfGroupItem(id, chain), file->sId, file->vId);
+        return HdfItem(new HdfItem::HdfGroupItem(id, chain), file->sId, file->vId, file->grId, file->budget);
     }
     case VDATA: {
         int32 id = VSattach(file->vId, ref, "r");
-        return HdfItem(new HdfItem::HdfDataItem(id, chain), file->sId, file->vId);
+        return HdfItem(new HdfItem::HdfDataItem(id, chain), file->sId, file->vId, file->grId, file->budget);
+    }
+    case GRIMAGE: {
+        int32 id = GRselect(file->grId, GRreftoindex(file->grId, (uint16)ref));
+        return HdfItem(new HdfItem::HdfImageItem(id, chain), file->sId, file->vId, file->grId, file->budget);
     }
     default: { raiseException(INVALID_OPERATION); }
     }
 }
+std::vector<hdf4cpp::HdfItemRef> hdf4cpp::HdfFile::getRefs() const {
+    std::vector<HdfItemRef> refs;
+    refs.reserve(getLoneRefs().size());
+    for (const auto &loneRef : loneRefs) {
+        int32 tag = (loneRef.second == VGROUP) ? DFTAG_VG : (loneRef.second == VDATA) ? DFTAG_VH : DFTAG_RIG;
+        refs.push_back(HdfItemRef(sId, vId, grId, budget, tag, loneRef.first, loneRef.second, chain));
+    }
+    return refs;
+}
@@ -0,0 +1,323 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfGeolocation.h>
+#include <hdf4cpp/HdfThreadPool.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <numeric>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace {
+/// The mean radius of the Earth in kilometers
+const float64 EARTH_RADIUS = 6371.0088;
+const float64 PI = 3.14159265358979323846;
+/// The first bytes of a sidecar file, the last one is the version of the format
+const char SIDECAR_MAGIC[8] = {'H', 'D', 'F', '4', 'G', 'E', 'O', '2'};
+
+/// Reads an SData item converted to float64
+struct CoordinateReader {
+    std::vector<float64> &values;
+
+    template <class T> void operator()(std::vector<T> &data) {
+        values.assign(data.begin(), data.end());
+    }
+};
+
+void toUnitSphere(float64 latitude, float64 longitude, float64 *point) {
+    float64 phi = latitude * PI / 180.0;
+    float64 lambda = longitude * PI / 180.0;
+    point[0] = std::cos(phi) * std::cos(lambda);
+    point[1] = std::cos(phi) * std::sin(lambda);
+    point[2] = std::sin(phi);
+}
+
+/// \returns the chord length on the unit sphere which belongs to a great circle distance in kilometers
+float64 chordOfDistance(float64 distance) {
+    if (!(distance < PI * EARTH_RADIUS)) {
+        return 2.0;
+    }
+    return 2.0 * std::sin(std::max(0.0, distance) / (2.0 * EARTH_RADIUS));
+}
+
+/// \returns the great circle distance in kilometers which belongs to a chord length on the unit sphere
+float64 distanceOfChord(float64 chord) {
+    return 2.0 * EARTH_RADIUS * std::asin(std::min(1.0, chord / 2.0));
+}
+
+float64 squaredDistance(const float64 *a, const float64 *b) {
+    float64 x = a[0] - b[0], y = a[1] - b[1], z = a[2] - b[2];
+    return x * x + y * y + z * z;
+}
+
+template <class T> void writeValues(std::ofstream &out, const std::vector<T> &values) {
+    out.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+template <class T> bool readValues(std::ifstream &in, std::vector<T> &values, size_t size) {
+    values.resize(size);
+    return (bool)in.read(reinterpret_cast<char *>(values.data()), size * sizeof(T));
+}
+}
+
+hdf4cpp::HdfGeolocationIndex::HdfGeolocationIndex(HdfItem &latitude, HdfItem &longitude)
+    : HdfObject(SDATA, ITEM) {
+    dims = latitude.getDims();
+    if (dims.size() != 2 || longitude.getDims() != dims) {
+        raiseException(INVALID_RANGES);
+    }
+    std::vector<float64> latitudes, longitudes;
+    latitude.readAny(CoordinateReader{latitudes});
+    longitude.readAny(CoordinateReader{longitudes});
+
+    std::vector<int32> order;
+    std::vector<float64> sphere;
+    for (size_t i = 0; i < latitudes.size(); ++i) {
+        if (std::fabs(latitudes[i]) <= 90.0 && std::fabs(longitudes[i]) <= 360.0) {
+            float64 point[3];
+            toUnitSphere(latitudes[i], longitudes[i], point);
+            sphere.insert(sphere.end(), point, point + 3);
+            order.push_back((int32)order.size());
+            pixels.push_back((int32)i);
+        }
+    }
+    points.swap(sphere);
+    axes.resize(order.size());
+    build(order, 0, order.size());
+
+    // the points and the pixels are stored in the order of the tree nodes
+    std::vector<float64> sortedPoints(points.size());
+    std::vector<int32> sortedPixels(pixels.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        std::memcpy(&sortedPoints[3 * i], &points[3 * (size_t)order[i]], 3 * sizeof(float64));
+        sortedPixels[i] = pixels[(size_t)order[i]];
+    }
+    points.swap(sortedPoints);
+    pixels.swap(sortedPixels);
+}
+hdf4cpp::HdfGeolocationIndex::HdfGeolocationIndex(const std::string &path)
+    : HdfObject(SDATA, ITEM) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(SIDECAR_MAGIC)];
+    std::uint64_t keySize, count;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, SIDECAR_MAGIC, sizeof(magic)) ||
+        !in.read(reinterpret_cast<char *>(&keySize), sizeof(keySize)) || keySize > (1 << 20)) {
+        raiseException(READ_FAIL);
+    }
+    key.resize((size_t)keySize);
+    if (!in.read(&key[0], (std::streamsize)keySize) || !readValues(in, dims, 2) ||
+        !in.read(reinterpret_cast<char *>(&count), sizeof(count)) || dims[0] < 0 || dims[1] < 0 ||
+        count > (std::uint64_t)dims[0] * (std::uint64_t)dims[1]) {
+        raiseException(READ_FAIL);
+    }
+    if (!readValues(in, points, 3 * (size_t)count) || !readValues(in, pixels, (size_t)count) ||
+        !readValues(in, axes, (size_t)count)) {
+        raiseException(READ_FAIL);
+    }
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        if (pixels[i] < 0 || (std::uint64_t)pixels[i] >= (std::uint64_t)dims[0] * (std::uint64_t)dims[1] ||
+            axes[i] > 2) {
+            raiseException(READ_FAIL);
+        }
+    }
+}
+hdf4cpp::HdfGeolocationIndex
+hdf4cpp::HdfGeolocationIndex::open(HdfItem &latitude,
+                                   HdfItem &longitude,
+                                   const std::string &sourcePath,
+                                   const std::string &path) {
+    std::string key = getSidecarKey(latitude, longitude, sourcePath);
+    if (std::ifstream(path, std::ios::binary)) {
+        try {
+            HdfGeolocationIndex index(path);
+            if (index.key == key) {
+                return index;
+            }
+        } catch (const HdfException &) {
+            // an outdated or damaged sidecar file is rebuilt
+        }
+    }
+    HdfGeolocationIndex index(latitude, longitude);
+    index.key = key;
+    index.save(path);
+    return index;
+}
+void hdf4cpp::HdfGeolocationIndex::save(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::uint64_t keySize = key.size(), count = pixels.size();
+    out.write(SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+    out.write(reinterpret_cast<const char *>(&keySize), sizeof(keySize));
+    out.write(key.data(), key.size());
+    writeValues(out, dims);
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    writeValues(out, points);
+    writeValues(out, pixels);
+    writeValues(out, axes);
+    if (!out) {
+        raiseException(WRITE_FAIL);
+    }
+}
+std::string hdf4cpp::HdfGeolocationIndex::getSidecarKey(HdfItem &latitude,
+                                                       HdfItem &longitude,
+                                                       const std::string &sourcePath) {
+#ifdef _WIN32
+    struct _stat status;
+    if (_stat(sourcePath.c_str(), &status)) {
+#else
+    struct stat status;
+    if (stat(sourcePath.c_str(), &status)) {
+#endif
+        throw HdfException(HFILE, FILE, READ_FAIL);
+    }
+    std::ostringstream key;
+    key << sourcePath << '\n' << (long long)status.st_mtime << ' ' << (long long)status.st_size;
+    for (HdfItem *item : {&latitude, &longitude}) {
+        key << '\n' << item->getName() << ' ' << item->getRef() << ' ' << item->getDataType();
+        for (const auto &dim : item->getDims()) {
+            key << ' ' << dim;
+        }
+    }
+    return key.str();
+}
+const std::vector<int32> &hdf4cpp::HdfGeolocationIndex::getDims() const {
+    return dims;
+}
+size_t hdf4cpp::HdfGeolocationIndex::size() const {
+    return pixels.size();
+}
+hdf4cpp::HdfPixel hdf4cpp::HdfGeolocationIndex::nearest(const HdfGeoPoint &point, float64 maxDistance) const {
+    float64 query[3];
+    toUnitSphere(point.latitude, point.longitude, query);
+    float64 chord = chordOfDistance(maxDistance);
+    // the nodes farther than the maximum distance are pruned from the start
+    float64 bestChord = chord * chord * (1.0 + 1e-12);
+    size_t best = pixels.size();
+    searchNearest(0, pixels.size(), query, best, bestChord);
+    if (best == pixels.size()) {
+        return HdfPixel{-1, -1, std::numeric_limits<float64>::infinity()};
+    }
+    return makePixel(best, std::sqrt(bestChord));
+}
+std::vector<hdf4cpp::HdfPixel>
+hdf4cpp::HdfGeolocationIndex::nearest(const std::vector<HdfGeoPoint> &queries, float64 maxDistance, size_t threads) const {
+    std::vector<HdfPixel> found(queries.size());
+    HdfThreadPool pool(threads);
+    size_t parts = std::min(queries.size(), 4 * pool.size());
+    std::vector<std::future<void>> futures;
+    for (size_t part = 0; part < parts; ++part) {
+        size_t begin = queries.size() * part / parts;
+        size_t end = queries.size() * (part + 1) / parts;
+        futures.push_back(pool.submit([this, &queries, &found, maxDistance, begin, end]() {
+            for (size_t i = begin; i < end; ++i) {
+                found[i] = nearest(queries[i], maxDistance);
+            }
+        }));
+    }
+    for (auto &future : futures) {
+        future.get();
+    }
+    return found;
+}
+std::vector<hdf4cpp::HdfPixel> hdf4cpp::HdfGeolocationIndex::withinRadius(const HdfGeoPoint &point,
+                                                                         float64 radius) const {
+    float64 query[3];
+    toUnitSphere(point.latitude, point.longitude, query);
+    float64 chord = chordOfDistance(radius);
+    std::vector<size_t> nodes;
+    searchRadius(0, pixels.size(), query, chord * chord * (1.0 + 1e-12), nodes);
+    std::vector<HdfPixel> found;
+    for (const auto &node : nodes) {
+        found.push_back(makePixel(node, std::sqrt(squaredDistance(&points[3 * node], query))));
+    }
+    std::sort(found.begin(), found.end(), [](const HdfPixel &a, const HdfPixel &b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.row < b.row) ||
+               (a.distance == b.distance && a.row == b.row && a.column < b.column);
+    });
+    return found;
+}
+void hdf4cpp::HdfGeolocationIndex::build(std::vector<int32> &order, size_t begin, size_t end) {
+    if (end - begin <= 1) {
+        return;
+    }
+    // the tree is split along the axis with the largest extent
+    float64 low[3] = {2.0, 2.0, 2.0}, high[3] = {-2.0, -2.0, -2.0};
+    for (size_t i = begin; i < end; ++i) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            low[axis] = std::min(low[axis], points[3 * (size_t)order[i] + axis]);
+            high[axis] = std::max(high[axis], points[3 * (size_t)order[i] + axis]);
+        }
+    }
+    uint8 axis = 0;
+    for (uint8 i = 1; i < 3; ++i) {
+        if (high[i] - low[i] > high[axis] - low[axis]) {
+            axis = i;
+        }
+    }
+    size_t middle = (begin + end) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [this, axis](int32 a, int32 b) {
+        return points[3 * (size_t)a + axis] < points[3 * (size_t)b + axis];
+    });
+    axes[middle] = axis;
+    build(order, begin, middle);
+    build(order, middle + 1, end);
+}
+void hdf4cpp::HdfGeolocationIndex::searchNearest(size_t begin,
+                                                 size_t end,
+                                                 const float64 *query,
+                                                 size_t &best,
+                                                 float64 &bestChord) const {
+    if (begin >= end) {
+        return;
+    }
+    size_t middle = (begin + end) / 2;
+    const float64 *point = &points[3 * middle];
+    float64 chord = squaredDistance(point, query);
+    if (chord < bestChord || (chord == bestChord && best < pixels.size() && pixels[middle] < pixels[best])) {
+        best = middle;
+        bestChord = chord;
+    }
+    float64 difference = query[axes[middle]] - point[axes[middle]];
+    if (difference < 0) {
+        searchNearest(begin, middle, query, best, bestChord);
+        if (difference * difference <= bestChord) {
+            searchNearest(middle + 1, end, query, best, bestChord);
+        }
+    } else {
+        searchNearest(middle + 1, end, query, best, bestChord);
+        if (difference * difference <= bestChord) {
+            searchNearest(begin, middle, query, best, bestChord);
+        }
+    }
+}
+void hdf4cpp::HdfGeolocationIndex::searchRadius(size_t begin,
+                                                size_t end,
+                                                const float64 *query,
+                                                float64 chord,
+                                                std::vector<size_t> &found) const {
+    if (begin >= end) {
+        return;
+    }
+    size_t middle = (begin + end) / 2;
+    const float64 *point = &points[3 * middle];
+    if (squaredDistance(point, query) <= chord) {
+        found.push_back(middle);
+    }
+    float64 difference = query[axes[middle]] - point[axes[middle]];
+    if (difference <= 0 || difference * difference <= chord) {
+        searchRadius(begin, middle, query, chord, found);
+    }
+    if (difference >= 0 || difference * difference <= chord) {
+        searchRadius(middle + 1, end, query, chord, found);
+    }
+}
+hdf4cpp::HdfPixel hdf4cpp::HdfGeolocationIndex::makePixel(size_t node, float64 chord) const {
+    return HdfPixel{pixels[node] / dims[1], pixels[node] % dims[1], distanceOfChord(chord)};
+}
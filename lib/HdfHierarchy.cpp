@@ -0,0 +1,227 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfHierarchy.h>
+#include <hdf4cpp/HdfThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mfhdf.h>
+
+hdf4cpp::HdfHierarchy::HdfHierarchy(const HdfFile &file)
+    : HdfObject(HFILE, FILE) {
+    for (const auto &ref : file.getRefs()) {
+        roots.push_back(addNode(ref));
+    }
+    expand(0);
+
+    // the VGroups of a cycle are members of each other, so none of them is lone: one VGroup of every cycle
+    // which is not reachable yet becomes a root
+    std::vector<std::pair<size_t, size_t>> cycleRoots;
+    for (int32 ref = Vgetid(file.getVId(), -1); ref != FAIL; ref = Vgetid(file.getVId(), ref)) {
+        if (find(VGROUP, ref) != nodes.size()) {
+            continue;
+        }
+        int32 id = Vattach(file.getVId(), ref, "r");
+        if (id == FAIL) {
+            raiseException(INVALID_ID);
+        }
+        char _class[MAX_NAME_LENGTH];
+        if (Vgetclass(id, _class) == FAIL) {
+            Vdetach(id);
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        Vdetach(id);
+        if (Visinternal(_class)) {
+            continue;
+        }
+        size_t node = addNode(
+            HdfItemRef(file.getSId(), file.getVId(), file.getGRId(), file.budget, DFTAG_VG, ref, VGROUP, file.chain));
+        expand(node);
+        cycleRoots.emplace_back(node, nodes.size());
+    }
+    // a root which became the member of a VGroup found later (e.g. a VGroup inside a cycle, listed before
+    // the cycle) is reachable from the later root, the parents within its own expansion are its cycle
+    for (const auto &root : cycleRoots) {
+        const std::vector<size_t> &parents = nodes[root.first].parents;
+        if (std::all_of(parents.begin(), parents.end(), [&root](size_t parent) { return parent < root.second; })) {
+            roots.push_back(root.first);
+        }
+    }
+
+    int32 datasets, attributes;
+    if (SDfileinfo(file.getSId(), &datasets, &attributes) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    for (int32 i = 0; i < datasets; ++i) {
+        int32 id = SDselect(file.getSId(), i);
+        if (id == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        int32 ref = SDidtoref(id);
+        char name[MAX_NAME_LENGTH];
+        SDgetinfo(id, name, nullptr, nullptr, nullptr, nullptr);
+        SDendaccess(id);
+        if (find(SDATA, ref) == nodes.size()) {
+            size_t node = addNode(
+                HdfItemRef(file.getSId(), file.getVId(), file.getGRId(), file.budget, DFTAG_NDG, ref, SDATA, file.chain));
+            nodes[node].name = name;
+            roots.push_back(node);
+        }
+    }
+
+    removeCycles();
+}
+void hdf4cpp::HdfHierarchy::expand(size_t first) {
+    // the new nodes are appended, so walking the vector by index expands every VGroup once
+    for (size_t i = first; i < nodes.size(); ++i) {
+        HdfItem item = nodes[i].ref.get();
+        nodes[i].name = item.getName();
+        for (const auto &member : item.getRefs()) {
+            size_t child = addNode(member);
+            nodes[i].children.push_back(child);
+            nodes[child].parents.push_back(i);
+        }
+    }
+}
+size_t hdf4cpp::HdfHierarchy::addNode(const HdfItemRef &ref) {
+    auto key = std::make_pair(ref.getType(), ref.getRef());
+    auto it = index.find(key);
+    if (it != index.end()) {
+        return it->second;
+    }
+    nodes.push_back(HdfNode{ref, std::string(), {}, {}});
+    index[key] = nodes.size() - 1;
+    return nodes.size() - 1;
+}
+void hdf4cpp::HdfHierarchy::removeCycles() {
+    // iterative depth first search, an edge to a node which is on the stack closes a cycle
+    enum Color { WHITE, GRAY, BLACK };
+    std::vector<Color> colors(nodes.size(), WHITE);
+    std::vector<std::pair<size_t, size_t>> stack;
+    for (const auto &root : roots) {
+        if (colors[root] != WHITE) {
+            continue;
+        }
+        colors[root] = GRAY;
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            size_t node = stack.back().first;
+            size_t &next = stack.back().second;
+            if (next == nodes[node].children.size()) {
+                colors[node] = BLACK;
+                stack.pop_back();
+                continue;
+            }
+            size_t child = nodes[node].children[next];
+            if (colors[child] == GRAY) {
+                cycleEdges.emplace_back(node, child);
+                nodes[node].children.erase(nodes[node].children.begin() + next);
+                std::vector<size_t> &parents = nodes[child].parents;
+                parents.erase(std::find(parents.begin(), parents.end(), node));
+                continue;
+            }
+            ++next;
+            if (colors[child] == WHITE) {
+                colors[child] = GRAY;
+                stack.emplace_back(child, 0);
+            }
+        }
+    }
+}
+size_t hdf4cpp::HdfHierarchy::size() const {
+    return nodes.size();
+}
+const hdf4cpp::HdfNode &hdf4cpp::HdfHierarchy::getNode(size_t index) const {
+    if (index >= nodes.size()) {
+        raiseException(OUT_OF_RANGE);
+    }
+    return nodes[index];
+}
+const std::vector<size_t> &hdf4cpp::HdfHierarchy::getRoots() const {
+    return roots;
+}
+size_t hdf4cpp::HdfHierarchy::find(Type type, int32 ref) const {
+    auto it = index.find(std::make_pair(type, ref));
+    return (it == index.end()) ? nodes.size() : it->second;
+}
+const std::vector<std::pair<size_t, size_t>> &hdf4cpp::HdfHierarchy::getCycleEdges() const {
+    return cycleEdges;
+}
+bool hdf4cpp::HdfHierarchy::hasCycles() const {
+    return !cycleEdges.empty();
+}
+void hdf4cpp::HdfHierarchy::visit(const Visitor &visitor) const {
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<size_t> stack(roots.rbegin(), roots.rend());
+    while (!stack.empty()) {
+        size_t node = stack.back();
+        stack.pop_back();
+        if (visited[node]) {
+            continue;
+        }
+        visited[node] = true;
+        if (visitor(nodes[node])) {
+            const std::vector<size_t> &children = nodes[node].children;
+            stack.insert(stack.end(), children.rbegin(), children.rend());
+        }
+    }
+}
+void hdf4cpp::HdfHierarchy::visitParallel(const ParallelVisitor &visitor, size_t threads) const {
+    // the hdf library has global state, so the accesses to every file are serialized
+    static std::mutex hdfMutex;
+    std::unique_ptr<std::atomic<bool>[]> claimed(new std::atomic<bool>[nodes.size()]);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        claimed[i] = false;
+    }
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t pending = 0;
+    std::exception_ptr error;
+
+    HdfThreadPool pool(threads);
+    std::function<void(size_t)> schedule = [&](size_t node) {
+        if (claimed[node].exchange(true)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error) {
+                return;
+            }
+            ++pending;
+        }
+        pool.submit([&, node]() {
+            try {
+                if (visitor(nodes[node], HdfNodeAccess(&nodes[node], &hdfMutex))) {
+                    for (const auto &child : nodes[node].children) {
+                        schedule(child);
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                done.notify_all();
+            }
+        });
+    };
+    for (const auto &root : roots) {
+        schedule(root);
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pending == 0; });
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
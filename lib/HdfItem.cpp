@@ -3,93 +3,520 @@
 
 
 #include <hdf4cpp/HdfAttribute.h>
+#include <hdf4cpp/HdfDimension.h>
 #include <hdf4cpp/HdfFile.h>
 #include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfMembership.h>
+#include <hdf4cpp/HdfThreadPool.h>
 #include <mfhdf.h>
 #include <numeric>
 #include <sstream>
 
+/// Instantiates the statistics computation once per number type
+struct hdf4cpp::HdfItem::HdfDatasetItem::StatisticsReader {
+    HdfDatasetItem *item;
+    const HdfStatisticsOptions &options;
+    const std::vector<Range> &ranges;
+    HdfStatistics &statistics;
+
+    template <class T> void operator()(HdfTypeTag<T>) {
+        statistics = item->computeStatistics<T>(options, ranges);
+    }
+};
+
+namespace {
+/// Adds up the data blocks which are returned by SDgetdatainfo or VSgetdatainfo
+/// \param query the call, it gets the number of the wanted blocks and the offset and the length array,
+/// without arrays it returns the number of the blocks
+/// \returns false if a call failed
+template <class Query> bool addBlocks(const Query &query, std::uint64_t &blockCount, std::uint64_t &storedSize) {
+    intn blocks = query(0, nullptr, nullptr);
+    if (blocks == FAIL) {
+        return false;
+    }
+    if (!blocks) {
+        return true;
+    }
+    std::vector<int32> offsets(blocks), lengths(blocks);
+    if (query((uintn)blocks, offsets.data(), lengths.data()) == FAIL) {
+        return false;
+    }
+    blockCount += (std::uint64_t)blocks;
+    for (const auto &length : lengths) {
+        storedSize += (std::uint64_t)length;
+    }
+    return true;
+}
+}
+
 hdf4cpp::HdfItem::HdfDatasetItem::HdfDatasetItem(int32 id, const HdfDestroyerChain &chain)
     : HdfItemBase(id, SDATA, chain) {
+    this->chain.emplaceBack(&SDendaccess, id);
+}
+void hdf4cpp::HdfItem::HdfDatasetItem::loadInfo() const {
     int32 dim[MAX_DIMENSION];
     int32 size;
     char _name[MAX_NAME_LENGTH];
-    SDgetinfo(id, _name, &size, dim, &dataType, nullptr);
-    dims = std::vector<int32>(dim, dim + size);
-    _size = std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<int32>());
-    name = std::string(_name);
-    this->chain.emplaceBack(&SDendaccess, id);
+    if (SDgetinfo(id, _name, &size, dim, &info.dataType, nullptr) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    info.dims = std::vector<int32>(dim, dim + size);
+    info.size = std::accumulate(info.dims.begin(), info.dims.end(), (size_t)1, std::multiplies<size_t>());
+    info.name = std::string(_name);
+    infoLoaded = true;
 }
 std::vector<int32> hdf4cpp::HdfItem::HdfDatasetItem::getDims() {
-    return dims;
+    return getInfo().dims;
 }
 hdf4cpp::HdfAttribute hdf4cpp::HdfItem::HdfDatasetItem::getAttribute(const std::string &name) const {
-    return HdfAttribute(new HdfAttribute::HdfDatasetAttribute(id, name, chain));
+    return std::move(tryGetAttribute(name).value());
+}
+hdf4cpp::HdfResult<hdf4cpp::HdfAttribute>
+hdf4cpp::HdfItem::HdfDatasetItem::tryGetAttribute(const std::string &name) const {
+    return HdfAttribute::tryOpen(id, SDATA, name, chain, budget);
+}
+std::vector<std::string> hdf4cpp::HdfItem::HdfDatasetItem::getAttributeNames() const {
+    int32 dims[MAX_DIMENSION];
+    int32 rank, dataType, size;
+    char _name[MAX_NAME_LENGTH];
+    if (SDgetinfo(id, _name, &rank, dims, &dataType, &size) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    std::vector<std::string> names;
+    for (int32 i = 0; i < size; ++i) {
+        int32 count;
+        if (SDattrinfo(id, i, _name, &dataType, &count) == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        names.push_back(std::string(_name));
+    }
+    return names;
 }
 std::string hdf4cpp::HdfItem::HdfDatasetItem::getName() const {
-    return name;
+    return getInfo().name;
 }
 int32 hdf4cpp::HdfItem::HdfDatasetItem::getId() const {
     return id;
 }
+int32 hdf4cpp::HdfItem::HdfDatasetItem::getRef() const {
+    int32 ref = SDidtoref(id);
+    if (ref == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    return ref;
+}
 hdf4cpp::HdfItem::HdfDatasetItem::~HdfDatasetItem() = default;
+hdf4cpp::HdfStatistics hdf4cpp::HdfItem::HdfDatasetItem::getStatistics(const HdfStatisticsOptions &options,
+                                                                       std::vector<Range> &ranges) {
+    Range::fill(ranges, getDims());
+    HdfStatistics statistics;
+    StatisticsReader reader{this, options, ranges, statistics};
+    if (!dispatchNumberType(getInfo().dataType, reader)) {
+        raiseException(INVALID_DATA_TYPE);
+    }
+    return statistics;
+}
+hdf4cpp::HdfStorageLayout hdf4cpp::HdfItem::HdfDatasetItem::getStorageLayout() const {
+    const Info &info = getInfo();
+    HdfStorageLayout layout;
+    size_t valueSize = numberTypeSize(info.dataType);
+    if (!valueSize) {
+        raiseException(INVALID_DATA_TYPE);
+    }
+    layout.logicalSize = (std::uint64_t)info.size * valueSize;
+
+    HDF_CHUNK_DEF chunk;
+    int32 flags;
+    if (SDgetchunkinfo(id, &chunk, &flags) == FAIL ||
+        SDgetcompinfo(id, &layout.compression, &layout.compressionInfo) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    layout.chunked = (flags & HDF_CHUNK) != 0;
+    if (!layout.chunked) {
+        auto query = [this](uintn count, int32 *offsets, int32 *lengths) {
+            return SDgetdatainfo(id, nullptr, 0, count, offsets, lengths);
+        };
+        if (!addBlocks(query, layout.blockCount, layout.storedSize)) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        return layout;
+    }
+    layout.chunkDims.assign(chunk.chunk_lengths, chunk.chunk_lengths + info.dims.size());
+    // every chunk of the grid is visited in row major order, the unwritten ones have no blocks
+    std::vector<int32> grid(info.dims.size()), coordinates(info.dims.size(), 0);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        if (layout.chunkDims[i] <= 0) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        grid[i] = (info.dims[i] + layout.chunkDims[i] - 1) / layout.chunkDims[i];
+        if (!grid[i]) {
+            return layout;
+        }
+    }
+    while (true) {
+        int32 *coordinate = coordinates.data();
+        auto query = [this, coordinate](uintn count, int32 *offsets, int32 *lengths) {
+            return SDgetdatainfo(id, coordinate, 0, count, offsets, lengths);
+        };
+        if (!addBlocks(query, layout.blockCount, layout.storedSize)) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        size_t i = grid.size();
+        while (i > 0 && ++coordinates[i - 1] == grid[i - 1]) {
+            coordinates[--i] = 0;
+        }
+        if (!i) {
+            return layout;
+        }
+    }
+}
+template <class T>
+hdf4cpp::HdfStatistics hdf4cpp::HdfItem::HdfDatasetItem::computeStatistics(const HdfStatisticsOptions &options,
+                                                                           const std::vector<Range> &ranges) {
+    T fill{};
+    bool hasFill = options.skipFillValue && getFillValue(fill);
+    size_t rowSize = 1;
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        rowSize *= ranges[i].size();
+    }
+    int32 bandRows = (int32)std::max<size_t>(1, STREAM_BUFFER_SIZE / std::max<size_t>(1, rowSize));
+
+    // the partial results are merged in band order, so the result does not depend on the scheduling
+    std::deque<HdfStatistics> partials;
+    std::unique_ptr<HdfThreadPool> ownPool;
+    HdfThreadPool *pool = options.pool;
+    if (!pool) {
+        ownPool.reset(new HdfThreadPool(options.threads));
+        pool = ownPool.get();
+    }
+    HdfTaskWindow window(*pool, pool->size() + 1);
+    readBands<T>(bandRows, ranges, [&](std::vector<T> &band, int32) {
+        std::shared_ptr<std::vector<T>> data = std::make_shared<std::vector<T>>(std::move(band));
+        partials.emplace_back();
+        HdfStatistics *partial = &partials.back();
+        window.submit([data, partial, hasFill, fill, &options]() {
+            accumulateStatistics(data->data(), data->size(), hasFill, fill, options, *partial);
+        });
+    });
+    window.wait();
+
+    HdfStatistics statistics;
+    for (const auto &partial : partials) {
+        statistics.merge(partial);
+    }
+    return statistics;
+}
 hdf4cpp::HdfItem::HdfGroupItem::HdfGroupItem(int32 id, const HdfDestroyerChain &chain)
     : HdfItemBase(id, VGROUP, chain) {
-    char _name[MAX_NAME_LENGTH];
-    Vgetname(id, _name);
-    name = std::string(_name);
     this->chain.emplaceBack(&Vdetach, id);
 }
 std::vector<int32> hdf4cpp::HdfItem::HdfGroupItem::getDims() {
     raiseException(INVALID_OPERATION);
 }
 hdf4cpp::HdfAttribute hdf4cpp::HdfItem::HdfGroupItem::getAttribute(const std::string &name) const {
-    return HdfAttribute(new HdfAttribute::HdfGroupAttribute(id, name, chain));
+    return std::move(tryGetAttribute(name).value());
+}
+hdf4cpp::HdfResult<hdf4cpp::HdfAttribute>
+hdf4cpp::HdfItem::HdfGroupItem::tryGetAttribute(const std::string &name) const {
+    return HdfAttribute::tryOpen(id, VGROUP, name, chain, budget);
+}
+std::vector<std::string> hdf4cpp::HdfItem::HdfGroupItem::getAttributeNames() const {
+    intn size = Vnattrs2(id);
+    if (size == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    std::vector<std::string> names;
+    for (intn i = 0; i < size; ++i) {
+        char _name[MAX_NAME_LENGTH];
+        int32 dataType, count, length, fields;
+        uint16 ref;
+        if (Vattrinfo2(id, i, _name, &dataType, &count, &length, &fields, &ref) == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        names.push_back(std::string(_name));
+    }
+    return names;
 }
 std::string hdf4cpp::HdfItem::HdfGroupItem::getName() const {
+    if (!nameLoaded) {
+        char _name[MAX_NAME_LENGTH];
+        if (Vgetname(id, _name) == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        name = std::string(_name);
+        nameLoaded = true;
+    }
     return name;
 }
 int32 hdf4cpp::HdfItem::HdfGroupItem::getId() const {
     return id;
 }
+int32 hdf4cpp::HdfItem::HdfGroupItem::getRef() const {
+    int32 ref = VQueryref(id);
+    if (ref == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    return ref;
+}
 hdf4cpp::HdfItem::HdfGroupItem::~HdfGroupItem() = default;
 hdf4cpp::HdfItem::HdfDataItem::HdfDataItem(int32 id, const HdfDestroyerChain &chain)
     : HdfItemBase(id, VDATA, chain) {
     this->chain.emplaceBack(&VSdetach, id);
+}
+void hdf4cpp::HdfItem::HdfDataItem::loadInfo() const {
     char _name[MAX_NAME_LENGTH];
-    VSinquire(id, &nrRecords, &interlace, nullptr, &recordSize, _name);
-    name = std::string(_name);
+    if (VSinquire(id, &info.nrRecords, &info.interlace, nullptr, &info.recordSize, _name) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    info.name = std::string(_name);
+    infoLoaded = true;
 }
 hdf4cpp::HdfItem::HdfDataItem::~HdfDataItem() = default;
 hdf4cpp::HdfAttribute hdf4cpp::HdfItem::HdfDataItem::getAttribute(const std::string &name) const {
-    return HdfAttribute(new HdfAttribute::HdfDataAttribute(id, name, chain));
+    return std::move(tryGetAttribute(name).value());
+}
+hdf4cpp::HdfResult<hdf4cpp::HdfAttribute>
+hdf4cpp::HdfItem::HdfDataItem::tryGetAttribute(const std::string &name) const {
+    return HdfAttribute::tryOpen(id, VDATA, name, chain, budget);
 }
 int32 hdf4cpp::HdfItem::HdfDataItem::getId() const {
     return id;
 }
+void hdf4cpp::HdfItem::HdfDataItem::readRecords(std::vector<uint8> &dest, int32 records, int32 first) {
+    const Info &info = getInfo();
+    if (first < 0 || records < 0 || records > info.nrRecords - first) {
+        raiseException(INVALID_RANGES);
+    }
+    std::vector<char> fields(MAX_FIELD_LIST_LENGTH);
+    if (VSinquire(id, nullptr, nullptr, fields.data(), nullptr, nullptr) == FAIL ||
+        VSsetfields(id, fields.data()) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    int32 recordSize = VSsizeof(id, fields.data());
+    if (recordSize == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    size_t size = (size_t)records * recordSize;
+    HdfMemoryBudget::Charge charged = charge(size);
+    if (!charged) {
+        raiseException(OUT_OF_BUDGET);
+    }
+    dest.resize(size);
+    if (!records) {
+        return;
+    }
+    seek(first);
+    // full interlace regardless of the file, so the records are the same however they are stored
+    if (VSread(id, dest.data(), records, FULL_INTERLACE) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    VSseek(id, 0);
+}
+hdf4cpp::HdfRecordLayout hdf4cpp::HdfItem::HdfDataItem::getRecordLayout() const {
+    const Info &info = getInfo();
+    HdfRecordLayout layout;
+    layout.recordCount = info.nrRecords;
+    layout.recordSize = info.recordSize;
+    layout.interlace = info.interlace;
+    int32 fields = VFnfields(id);
+    if (fields == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    for (int32 i = 0; i < fields; ++i) {
+        HdfRecordField field;
+        const char *name = VFfieldname(id, i);
+        field.dataType = VFfieldtype(id, i);
+        field.order = VFfieldorder(id, i);
+        if (!name || field.dataType == FAIL || field.order == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        field.name = name;
+        layout.fields.push_back(field);
+    }
+    if (VSgetblockinfo(id, &layout.linkedBlockSize, &layout.linkedBlockCount) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    auto query = [this](uintn count, int32 *offsets, int32 *lengths) {
+        return VSgetdatainfo(id, 0, count, offsets, lengths);
+    };
+    if (!addBlocks(query, layout.blockCount, layout.storedSize)) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    return layout;
+}
+int32 hdf4cpp::HdfItem::HdfDataItem::getRef() const {
+    int32 ref = VSQueryref(id);
+    if (ref == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    return ref;
+}
+std::vector<std::string> hdf4cpp::HdfItem::HdfDataItem::getAttributeNames() const {
+    intn size = VSfnattrs(id, _HDF_VDATA);
+    if (size == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    std::vector<std::string> names;
+    for (intn i = 0; i < size; ++i) {
+        char _name[MAX_NAME_LENGTH];
+        int32 dataType, count, length;
+        if (VSattrinfo(id, _HDF_VDATA, i, _name, &dataType, &count, &length) == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        names.push_back(std::string(_name));
+    }
+    return names;
+}
 std::string hdf4cpp::HdfItem::HdfDataItem::getName() const {
-    return name;
+    return getInfo().name;
 }
 std::vector<int32> hdf4cpp::HdfItem::HdfDataItem::getDims() {
     raiseException(INVALID_OPERATION);
 }
-hdf4cpp::HdfItem::HdfItem(HdfItemBase *item, int32 sId, int32 vId)
+hdf4cpp::HdfItem::HdfImageItem::HdfImageItem(int32 id, const HdfDestroyerChain &chain)
+    : HdfItemBase(id, GRIMAGE, chain) {
+    this->chain.emplaceBack(&GRendaccess, id);
+}
+hdf4cpp::HdfItem::HdfImageItem::~HdfImageItem() = default;
+void hdf4cpp::HdfItem::HdfImageItem::loadInfo() const {
+    char _name[MAX_NAME_LENGTH];
+    int32 interlace, dims[2], attributes;
+    if (GRgetiminfo(id, _name, &info.components, &info.dataType, &interlace, dims, &attributes) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    info.name = std::string(_name);
+    // GR gives the width first, the dimensions are stored in row major order
+    info.dims = {dims[1], dims[0]};
+    infoLoaded = true;
+}
+int32 hdf4cpp::HdfItem::HdfImageItem::getId() const {
+    return id;
+}
+int32 hdf4cpp::HdfItem::HdfImageItem::getRef() const {
+    uint16 ref = GRidtoref(id);
+    if (ref == 0 || ref == (uint16)FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    return ref;
+}
+std::string hdf4cpp::HdfItem::HdfImageItem::getName() const {
+    return getInfo().name;
+}
+std::vector<int32> hdf4cpp::HdfItem::HdfImageItem::getDims() {
+    return getInfo().dims;
+}
+hdf4cpp::HdfAttribute hdf4cpp::HdfItem::HdfImageItem::getAttribute(const std::string &name) const {
+    return std::move(tryGetAttribute(name).value());
+}
+hdf4cpp::HdfResult<hdf4cpp::HdfAttribute>
+hdf4cpp::HdfItem::HdfImageItem::tryGetAttribute(const std::string &name) const {
+    return HdfAttribute::tryOpen(id, GRIMAGE, name, chain, budget);
+}
+std::vector<std::string> hdf4cpp::HdfItem::HdfImageItem::getAttributeNames() const {
+    char _name[MAX_NAME_LENGTH];
+    int32 components, dataType, interlace, dims[2], size;
+    if (GRgetiminfo(id, _name, &components, &dataType, &interlace, dims, &size) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    std::vector<std::string> names;
+    for (int32 i = 0; i < size; ++i) {
+        int32 count;
+        if (GRattrinfo(id, i, _name, &dataType, &count) == FAIL) {
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        names.push_back(std::string(_name));
+    }
+    return names;
+}
+hdf4cpp::HdfStatus hdf4cpp::HdfItem::HdfImageItem::checkWindow(std::vector<Range> &ranges, size_t &length) const {
+    const Info &info = getInfo();
+    Range::fill(ranges, info.dims);
+    if (ranges.size() != info.dims.size()) {
+        return error(INVALID_RANGES);
+    }
+    length = (size_t)info.components;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (!ranges[i].check(info.dims[i])) {
+            return error(INVALID_RANGES);
+        }
+        length *= ranges[i].size();
+    }
+    return HdfStatus();
+}
+hdf4cpp::HdfStatus hdf4cpp::HdfItem::HdfImageItem::readWindow(void *dest,
+                                                              const std::vector<Range> &ranges,
+                                                              Interlace interlace) const {
+    intn mode = MFGR_INTERLACE_PIXEL;
+    switch (interlace) {
+    case INTERLACE_PIXEL:
+        mode = MFGR_INTERLACE_PIXEL;
+        break;
+    case INTERLACE_LINE:
+        mode = MFGR_INTERLACE_LINE;
+        break;
+    case INTERLACE_COMPONENT:
+        mode = MFGR_INTERLACE_COMPONENT;
+        break;
+    }
+    // GR addresses the pixels by (column, row)
+    int32 start[2] = {ranges[1].begin, ranges[0].begin};
+    int32 stride[2] = {ranges[1].stride, ranges[0].stride};
+    int32 edges[2] = {ranges[1].size(), ranges[0].size()};
+    if (!edges[0] || !edges[1]) {
+        return HdfStatus();
+    }
+    if (GRreqimageil(id, mode) == FAIL || GRreadimage(id, start, stride, edges, dest) == FAIL) {
+        return error(STATUS_RETURN_FAIL);
+    }
+    return HdfStatus();
+}
+hdf4cpp::HdfItem::HdfImageItem::Palette hdf4cpp::HdfItem::HdfImageItem::getPalette() const {
+    Palette palette{GRgetlutid(id, 0), 0, 0, 0};
+    int32 interlace;
+    if (palette.id == FAIL ||
+        GRgetlutinfo(palette.id, &palette.components, &palette.dataType, &interlace, &palette.entries) == FAIL ||
+        palette.components <= 0 || palette.entries <= 0) {
+        // the image has no palette
+        return Palette{FAIL, 0, 0, 0};
+    }
+    return palette;
+}
+void hdf4cpp::HdfItem::HdfImageItem::readPalette(const Palette &palette, void *dest) const {
+    if (GRreqlutil(palette.id, MFGR_INTERLACE_PIXEL) == FAIL || GRreadlut(palette.id, dest) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+}
+std::vector<int32> hdf4cpp::HdfItem::HdfImageItem::getPaletteDims() const {
+    Palette palette = getPalette();
+    return {palette.entries, palette.components};
+}
+hdf4cpp::HdfItem::HdfItem(HdfItemBase *item,
+                          int32 sId,
+                          int32 vId,
+                          int32 grId,
+                          const std::shared_ptr<HdfMemoryBudget> &budget)
     : HdfObject(item)
     , item(item)
     , sId(sId)
-    , vId(vId) {
+    , vId(vId)
+    , grId(grId) {
+    this->item->setBudget(budget);
 }
 hdf4cpp::HdfItem::HdfItem(HdfItem &&other) noexcept
     : HdfObject(other.getType(), other.getClassType(), std::move(other.chain))
     , item(std::move(other.item))
     , sId(other.sId)
-    , vId(other.vId) {
+    , vId(other.vId)
+    , grId(other.grId) {
 }
 hdf4cpp::HdfItem &hdf4cpp::HdfItem::operator=(HdfItem &&it) noexcept {
     setType(it.getType());
     setClassType(it.getClassType());
     chain = std::move(it.chain);
     item = std::move(it.item);
+    sId = it.sId;
+    vId = it.vId;
+    grId = it.grId;
     return *this;
 }
 std::vector<int32> hdf4cpp::HdfItem::getDims() {
@@ -98,18 +525,286 @@ std::vector<int32> hdf4cpp::HdfItem::getDims() {
 hdf4cpp::HdfAttribute hdf4cpp::HdfItem::getAttribute(const std::string &name) const {
     return item->getAttribute(name);
 }
+hdf4cpp::HdfResult<hdf4cpp::HdfAttribute> hdf4cpp::HdfItem::tryGetAttribute(const std::string &name) const {
+    return item->tryGetAttribute(name);
+}
 std::string hdf4cpp::HdfItem::getName() const {
     return item->getName();
 }
+int32 hdf4cpp::HdfItem::getRef() const {
+    return item->getRef();
+}
+std::vector<std::string> hdf4cpp::HdfItem::getAttributeNames() const {
+    return item->getAttributeNames();
+}
+std::vector<hdf4cpp::HdfDimension> hdf4cpp::HdfItem::getDimensions() const {
+    if (item->getType() != SDATA) {
+        raiseException(INVALID_OPERATION);
+    }
+    std::vector<HdfDimension> dimensions;
+    int32 rank = (int32)item->getDims().size();
+    for (int32 i = 0; i < rank; ++i) {
+        dimensions.push_back(getDimension(i));
+    }
+    return dimensions;
+}
+hdf4cpp::HdfDimension hdf4cpp::HdfItem::getDimension(int32 index) const {
+    if (item->getType() != SDATA) {
+        raiseException(INVALID_OPERATION);
+    }
+    std::vector<int32> dims = item->getDims();
+    if (index < 0 || index >= (int32)dims.size()) {
+        raiseException(OUT_OF_RANGE);
+    }
+    int32 id = SDgetdimid(item->getId(), index);
+    if (id == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    char _name[MAX_NAME_LENGTH];
+    int32 size, dataType, attributes;
+    if (SDdiminfo(id, _name, &size, &dataType, &attributes) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    // SDdiminfo gives 0 as the size of an unlimited dimension, the current size is the one of the dataset
+    std::string name(_name);
+    return HdfDimension(sId,
+                        id,
+                        name,
+                        dims[index],
+                        size == SD_UNLIMITED,
+                        dataType,
+                        HdfDimension::getSharedScale(sId, chain.getToken(), name, dims[index]),
+                        chain);
+}
+std::vector<hdf4cpp::Range> hdf4cpp::HdfItem::getCoordinateRanges(const std::vector<HdfInterval> &intervals) const {
+    if (item->getType() != SDATA) {
+        raiseException(INVALID_OPERATION);
+    }
+    std::vector<int32> dims = item->getDims();
+    if (intervals.size() > dims.size()) {
+        raiseException(INVALID_RANGES);
+    }
+    std::vector<Range> ranges;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        if (i < intervals.size()) {
+            ranges.push_back(getDimension((int32)i).getCoordinateIndex().find(intervals[i]));
+        } else {
+            ranges.push_back(Range(0, dims[i]));
+        }
+    }
+    return ranges;
+}
+int32 hdf4cpp::HdfItem::getRecordCount() const {
+    switch (item->getType()) {
+    case VDATA: {
+        HdfDataItem *vItem = static_cast<HdfDataItem *>(item.get());
+        return vItem->getRecordCount();
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
+void hdf4cpp::HdfItem::readRecords(std::vector<uint8> &dest, int32 records, int32 first) {
+    switch (item->getType()) {
+    case VDATA: {
+        HdfDataItem *vItem = static_cast<HdfDataItem *>(item.get());
+        vItem->readRecords(dest, records, first);
+        break;
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
+int32 hdf4cpp::HdfItem::getDataType() const {
+    switch (item->getType()) {
+    case SDATA: {
+        HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+        return dItem->getDataType();
+    }
+    case GRIMAGE: {
+        HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+        return iItem->getDataType();
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
+int32 hdf4cpp::HdfItem::getComponentCount() const {
+    switch (item->getType()) {
+    case GRIMAGE: {
+        HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+        return iItem->getComponentCount();
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
+bool hdf4cpp::HdfItem::hasPalette() const {
+    return getPaletteDims().front() > 0;
+}
+std::vector<int32> hdf4cpp::HdfItem::getPaletteDims() const {
+    switch (item->getType()) {
+    case GRIMAGE: {
+        HdfImageItem *iItem = static_cast<HdfImageItem *>(item.get());
+        return iItem->getPaletteDims();
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
+hdf4cpp::HdfStorageLayout hdf4cpp::HdfItem::getStorageLayout() const {
+    switch (item->getType()) {
+    case SDATA: {
+        HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+        return dItem->getStorageLayout();
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
+hdf4cpp::HdfRecordLayout hdf4cpp::HdfItem::getRecordLayout() const {
+    switch (item->getType()) {
+    case VDATA: {
+        HdfDataItem *vItem = static_cast<HdfDataItem *>(item.get());
+        return vItem->getRecordLayout();
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
+hdf4cpp::HdfStatistics hdf4cpp::HdfItem::getStatistics(const HdfStatisticsOptions &options, std::vector<Range> ranges) {
+    switch (item->getType()) {
+    case SDATA: {
+        HdfDatasetItem *dItem = static_cast<HdfDatasetItem *>(item.get());
+        return dItem->getStatistics(options, ranges);
+    }
+    default:
+        raiseException(INVALID_OPERATION);
+    }
+}
 hdf4cpp::HdfItem::Iterator hdf4cpp::HdfItem::begin() const {
-    return Iterator(sId, vId, item->getId(), 0, getType(), chain);
+    return Iterator(sId, vId, grId, item->getBudget(), item->getId(), 0, getType(), chain);
 }
 hdf4cpp::HdfItem::Iterator hdf4cpp::HdfItem::end() const {
     switch (item->getType()) {
     case VGROUP: {
         int32 size = Vntagrefs(item->getId());
-        return Iterator(sId, vId, item->getId(), size, getType(), chain);
+        return Iterator(sId, vId, grId, item->getBudget(), item->getId(), size, getType(), chain);
+    }
+    default: { return Iterator(sId, vId, grId, item->getBudget(), item->getId(), 0, getType(), chain); }
+    }
+}
+std::vector<hdf4cpp::HdfItemRef> hdf4cpp::HdfItem::getRefs() const {
+    std::vector<HdfItemRef> refs;
+    if (item->getType() != VGROUP) {
+        return refs;
     }
-    default: { return Iterator(sId, vId, item->getId(), 0, getType(), chain); }
+    int32 size = Vntagrefs(item->getId());
+    if (size == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    std::vector<int32> tags((size_t)size), refNums((size_t)size);
+    if (size && Vgettagrefs(item->getId(), tags.data(), refNums.data(), size) == FAIL) {
+        raiseException(STATUS_RETURN_FAIL);
+    }
+    refs.reserve((size_t)size);
+    for (int32 i = 0; i < size; ++i) {
+        Type type;
+        if (HdfItemRef::typeOfTag(tags[i], type)) {
+            refs.push_back(HdfItemRef(sId, vId, grId, item->getBudget(), tags[i], refNums[i], type, chain));
+        }
+    }
+    return refs;
+}
+std::vector<hdf4cpp::HdfItemRef> hdf4cpp::HdfItem::getParents() const {
+    std::shared_ptr<const HdfMembershipIndex> index = HdfMembershipIndex::forFile(vId, chain.getToken());
+    const std::vector<int32> &parents = index->getParents(item->getType(), item->getRef());
+    std::vector<HdfItemRef> refs;
+    refs.reserve(parents.size());
+    for (const auto &parent : parents) {
+        refs.push_back(HdfItemRef(sId, vId, grId, item->getBudget(), DFTAG_VG, parent, VGROUP, chain));
+    }
+    return refs;
+}
+std::string hdf4cpp::HdfItem::getPath() const {
+    return getPaths().front();
+}
+std::vector<std::string> hdf4cpp::HdfItem::getPaths() const {
+    std::shared_ptr<const HdfMembershipIndex> index = HdfMembershipIndex::forFile(vId, chain.getToken());
+    std::vector<std::vector<int32>> groupPaths = index->getGroupPaths(item->getType(), item->getRef());
+    if (groupPaths.empty()) {
+        groupPaths.emplace_back();
+    }
+    std::vector<std::string> paths;
+    for (const auto &groupPath : groupPaths) {
+        std::string path;
+        for (const auto &group : groupPath) {
+            path += '/' + index->getGroupName(group);
+        }
+        paths.push_back(path + '/' + getName());
+    }
+    return paths;
+}
+hdf4cpp::HdfItemRef::HdfItemRef(int32 sId,
+                                int32 vId,
+                                int32 grId,
+                                const std::shared_ptr<HdfMemoryBudget> &budget,
+                                int32 tag,
+                                int32 ref,
+                                Type type,
+                                const HdfDestroyerChain &chain)
+    : HdfObject(type, ITEM, chain)
+    , sId(sId)
+    , vId(vId)
+    , grId(grId)
+    , budget(budget)
+    , tag(tag)
+    , ref(ref) {
+}
+int32 hdf4cpp::HdfItemRef::getTag() const {
+    return tag;
+}
+int32 hdf4cpp::HdfItemRef::getRef() const {
+    return ref;
+}
+hdf4cpp::HdfItem hdf4cpp::HdfItemRef::get() const {
+    switch (getType()) {
+    case SDATA: {
+        int32 id = SDselect(sId, SDreftoindex(sId, ref));
+        return HdfItem(new HdfItem::HdfDatasetItem(id, chain), sId, vId, grId, budget);
+    }
+    case VGROUP: {
+        int32 id = Vattach(vId, ref, "r");
+        return HdfItem(new HdfItem::HdfGroupItem(id, chain), sId, vId, grId, budget);
+    }
+    case VDATA: {
+        int32 id = VSattach(vId, ref, "r");
+        return HdfItem(new HdfItem::HdfDataItem(id, chain), sId, vId, grId, budget);
+    }
+    case GRIMAGE: {
+        int32 id = GRselect(grId, GRreftoindex(grId, (uint16)ref));
+        return HdfItem(new HdfItem::HdfImageItem(id, chain), sId, vId, grId, budget);
+    }
+    default: { raiseException(INVALID_OPERATION); }
+    }
+}
+bool hdf4cpp::HdfItemRef::typeOfTag(int32 tag, Type &type) {
+    switch (tag) {
+    case DFTAG_NDG:
+    case DFTAG_SDG:
+    case DFTAG_SD:
+        type = SDATA;
+        return true;
+    case DFTAG_VG:
+        type = VGROUP;
+        return true;
+    case DFTAG_VH:
+        type = VDATA;
+        return true;
+    case DFTAG_RIG:
+        type = GRIMAGE;
+        return true;
+    default:
+        return false;
     }
 }
@@ -0,0 +1,100 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfFileLocal.h>
+#include <hdf4cpp/HdfItem.h>
+#include <hdf4cpp/HdfMembership.h>
+
+#include <algorithm>
+#include <hdf.h>
+
+hdf4cpp::HdfMembershipIndex::HdfMembershipIndex(int32 vId)
+    : HdfObject(HFILE, FILE) {
+    std::vector<int32> tags, refs;
+    for (int32 ref = Vgetid(vId, -1); ref != FAIL; ref = Vgetid(vId, ref)) {
+        int32 id = Vattach(vId, ref, "r");
+        if (id == FAIL) {
+            raiseException(INVALID_ID);
+        }
+        char _name[MAX_NAME_LENGTH];
+        char _class[MAX_NAME_LENGTH];
+        int32 size = Vntagrefs(id);
+        if (Vgetname(id, _name) == FAIL || Vgetclass(id, _class) == FAIL || size == FAIL) {
+            Vdetach(id);
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        if (Visinternal(_class)) {
+            Vdetach(id);
+            continue;
+        }
+        tags.resize((size_t)size);
+        refs.resize((size_t)size);
+        if (size && Vgettagrefs(id, tags.data(), refs.data(), size) == FAIL) {
+            Vdetach(id);
+            raiseException(STATUS_RETURN_FAIL);
+        }
+        Vdetach(id);
+
+        groupNames[ref] = std::string(_name);
+        for (int32 i = 0; i < size; ++i) {
+            Type type;
+            if (HdfItemRef::typeOfTag(tags[i], type)) {
+                std::vector<int32> &groups = parents[std::make_pair(type, refs[i])];
+                if (std::find(groups.begin(), groups.end(), ref) == groups.end()) {
+                    groups.push_back(ref);
+                }
+            }
+        }
+    }
+    // members pointing to an internal VGroup are dropped, they are not part of the user visible structure
+    for (auto it = parents.begin(); it != parents.end();) {
+        if (it->first.first == VGROUP && !groupNames.count(it->first.second)) {
+            it = parents.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+const std::vector<int32> &hdf4cpp::HdfMembershipIndex::getParents(Type type, int32 ref) const {
+    static const std::vector<int32> none;
+    auto it = parents.find(std::make_pair(type, ref));
+    return (it == parents.end()) ? none : it->second;
+}
+const std::string &hdf4cpp::HdfMembershipIndex::getGroupName(int32 ref) const {
+    auto it = groupNames.find(ref);
+    if (it == groupNames.end()) {
+        raiseException(INVALID_ID);
+    }
+    return it->second;
+}
+std::vector<std::vector<int32>> hdf4cpp::HdfMembershipIndex::getGroupPaths(Type type, int32 ref) const {
+    std::vector<std::vector<int32>> paths;
+    std::vector<int32> path;
+    for (const auto &parent : getParents(type, ref)) {
+        collectPaths(parent, path, paths);
+    }
+    return paths;
+}
+void hdf4cpp::HdfMembershipIndex::collectPaths(int32 group,
+                                               std::vector<int32> &path,
+                                               std::vector<std::vector<int32>> &paths) const {
+    // the path is built from the item upwards and reversed when a top VGroup is reached
+    path.push_back(group);
+    bool extended = false;
+    for (const auto &parent : getParents(VGROUP, group)) {
+        if (std::find(path.begin(), path.end(), parent) == path.end()) {
+            collectPaths(parent, path, paths);
+            extended = true;
+        }
+    }
+    if (!extended) {
+        paths.emplace_back(path.rbegin(), path.rend());
+    }
+    path.pop_back();
+}
+std::shared_ptr<const hdf4cpp::HdfMembershipIndex>
+hdf4cpp::HdfMembershipIndex::forFile(int32 vId, const std::weak_ptr<const void> &token) {
+    static HdfFileLocal<const HdfMembershipIndex> indices;
+    return indices.get(vId, token, [vId]() { return std::make_shared<const HdfMembershipIndex>(vId); });
+}
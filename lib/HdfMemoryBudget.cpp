@@ -0,0 +1,102 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfFileLocal.h>
+#include <hdf4cpp/HdfMemoryBudget.h>
+
+#include <algorithm>
+#include <limits>
+
+hdf4cpp::HdfMemoryBudget::Charge::Charge(HdfMemoryBudget *file, size_t bytes, bool accepted)
+    : file(file)
+    , bytes(bytes)
+    , accepted(accepted) {
+}
+hdf4cpp::HdfMemoryBudget::Charge::Charge(Charge &&other) noexcept
+    : file(other.file)
+    , bytes(other.bytes)
+    , accepted(other.accepted) {
+    other.accepted = false;
+}
+hdf4cpp::HdfMemoryBudget::Charge::~Charge() {
+    if (accepted) {
+        process().release(bytes);
+        if (file) {
+            file->release(bytes);
+        }
+    }
+}
+hdf4cpp::HdfMemoryBudget::HdfMemoryBudget(size_t limit)
+    : limit(limit) {
+}
+void hdf4cpp::HdfMemoryBudget::setLimit(size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->limit = limit;
+}
+size_t hdf4cpp::HdfMemoryBudget::getLimit() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return limit;
+}
+hdf4cpp::HdfMemoryStats hdf4cpp::HdfMemoryBudget::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return HdfMemoryStats{limit, inUse, peak, rejected};
+}
+void hdf4cpp::HdfMemoryBudget::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    peak = inUse;
+    rejected = 0;
+}
+hdf4cpp::HdfMemoryBudget &hdf4cpp::HdfMemoryBudget::process() {
+    static HdfMemoryBudget budget;
+    return budget;
+}
+std::shared_ptr<hdf4cpp::HdfMemoryBudget> hdf4cpp::HdfMemoryBudget::ofFile(int32 sId,
+                                                                         const std::weak_ptr<const void> &token) {
+    static HdfFileLocal<HdfMemoryBudget> budgets;
+    return budgets.get(sId, token, []() { return std::make_shared<HdfMemoryBudget>(); });
+}
+hdf4cpp::HdfMemoryBudget::Charge hdf4cpp::HdfMemoryBudget::charge(HdfMemoryBudget *file, size_t bytes) {
+    size_t peak;
+    if (!process().tryCharge(bytes, peak)) {
+        return Charge(file, bytes, false);
+    }
+    size_t filePeak;
+    if (file && !file->tryCharge(bytes, filePeak)) {
+        process().rollback(bytes, peak);
+        return Charge(file, bytes, false);
+    }
+    return Charge(file, bytes, true);
+}
+size_t hdf4cpp::HdfMemoryBudget::getAvailable(const HdfMemoryBudget *file) {
+    size_t available = process().getAvailable();
+    return file ? std::min(available, file->getAvailable()) : available;
+}
+bool hdf4cpp::HdfMemoryBudget::tryCharge(size_t bytes, size_t &previousPeak) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (limit && (bytes > limit || inUse > limit - bytes)) {
+        ++rejected;
+        return false;
+    }
+    previousPeak = peak;
+    inUse += bytes;
+    peak = std::max(peak, inUse);
+    return true;
+}
+void hdf4cpp::HdfMemoryBudget::rollback(size_t bytes, size_t previousPeak) {
+    std::lock_guard<std::mutex> lock(mutex);
+    inUse -= std::min(inUse, bytes);
+    // the usage of the charges made in the meantime is kept in the peak
+    peak = std::max(previousPeak, std::min(peak, inUse));
+}
+void hdf4cpp::HdfMemoryBudget::release(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    inUse -= std::min(inUse, bytes);
+}
+size_t hdf4cpp::HdfMemoryBudget::getAvailable() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!limit) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return limit - std::min(limit, inUse);
+}
@@ -0,0 +1,339 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfPyramid.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace {
+/// The first bytes of a cache file, the last one is the version of the format
+const char CACHE_MAGIC[8] = {'H', 'D', 'F', '4', 'P', 'Y', 'R', '1'};
+/// The factor of a level must fit into int32
+const size_t MAX_LEVELS = 30;
+
+size_t volumeOf(const std::vector<int32> &dims) {
+    size_t volume = 1;
+    for (const auto &dim : dims) {
+        volume *= (size_t)dim;
+    }
+    return volume;
+}
+
+/// \returns the dimensions reduced by the factor along the first two dimensions
+std::vector<int32> reduceDims(std::vector<int32> dims, std::int64_t factor) {
+    for (size_t i = 0; i < dims.size() && i < 2; ++i) {
+        dims[i] = (int32)((dims[i] + factor - 1) / factor);
+    }
+    return dims;
+}
+
+int32 largerOfFirstTwo(const std::vector<int32> &dims) {
+    return dims.size() > 1 ? std::max(dims[0], dims[1]) : dims[0];
+}
+
+/// Streams the item band by band into one block reducer per level
+struct LevelBuilder {
+    hdf4cpp::HdfItem &item;
+    const std::vector<int32> &dims;
+    hdf4cpp::Aggregation aggregation;
+    const std::vector<std::vector<int32>> &levelDims;
+    std::vector<std::vector<float64>> &levels;
+
+    template <class T> void operator()(hdf4cpp::HdfTypeTag<T>) {
+        std::vector<hdf4cpp::HdfBlockReducer<T, float64>> reducers;
+        for (size_t i = 0; i < levelDims.size(); ++i) {
+            int32 factor = 2 << i;
+            reducers.emplace_back(aggregation, dims, std::vector<int32>({factor, factor}));
+            levels[i].resize(volumeOf(levelDims[i]));
+        }
+        if (reducers.empty()) {
+            return;
+        }
+        // the bands begin at block boundaries of every level
+        int32 bandRows = reducers.back().getBandRows(STREAM_BUFFER_SIZE);
+        std::vector<hdf4cpp::Range> ranges;
+        for (const auto &dim : dims) {
+            ranges.push_back(hdf4cpp::Range(0, dim));
+        }
+        std::vector<T> band;
+        for (int32 row = 0; row < dims[0]; row += bandRows) {
+            int32 rows = std::min(bandRows, dims[0] - row);
+            ranges[0] = hdf4cpp::Range(row, rows);
+            item.read(band, ranges);
+            for (size_t i = 0; i < reducers.size(); ++i) {
+                reducers[i].consume(band.data(), rows, levels[i].data());
+            }
+        }
+    }
+};
+
+/// Copies a window of a row major array
+void copyWindow(const float64 *data,
+                const std::vector<int32> &shape,
+                const std::vector<hdf4cpp::Range> &ranges,
+                std::vector<float64> &dest) {
+    size_t rank = shape.size();
+    std::vector<size_t> steps(rank, 1);
+    for (size_t i = rank - 1; i > 0; --i) {
+        steps[i - 1] = steps[i] * (size_t)shape[i];
+    }
+    size_t volume = 1;
+    for (const auto &range : ranges) {
+        volume *= (size_t)range.size();
+    }
+    dest.resize(volume);
+    if (!volume) {
+        return;
+    }
+    const hdf4cpp::Range &last = ranges[rank - 1];
+    std::vector<int32> index(rank, 0);
+    for (size_t out = 0; out < volume; out += (size_t)last.size()) {
+        size_t offset = 0;
+        for (size_t i = 0; i + 1 < rank; ++i) {
+            offset += ((size_t)ranges[i].begin + (size_t)index[i] * ranges[i].stride) * steps[i];
+        }
+        for (int32 j = 0; j < last.size(); ++j) {
+            dest[out + j] = data[offset + (size_t)last.begin + (size_t)j * last.stride];
+        }
+        for (size_t i = rank - 1; i-- > 0;) {
+            if (++index[i] < ranges[i].size()) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+}
+
+std::string hexHash(const std::string &text) {
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const auto &c : text) {
+        hash = (hash ^ (unsigned char)c) * 1099511628211ULL;
+    }
+    std::ostringstream out;
+    out << std::hex << hash;
+    return out.str();
+}
+
+std::string cachePathOf(const std::string &cacheDirectory, const std::string &key) {
+    return cacheDirectory + "/" + hexHash(key) + ".pyramid";
+}
+
+template <class T> void writeValue(std::ofstream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T> bool readValue(std::ifstream &in, T &value) {
+    return (bool)in.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+template <class T> void writeValues(std::ofstream &out, const std::vector<T> &values) {
+    out.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+template <class T> bool readValues(std::ifstream &in, std::vector<T> &values, size_t size) {
+    values.resize(size);
+    return (bool)in.read(reinterpret_cast<char *>(values.data()), size * sizeof(T));
+}
+}
+
+hdf4cpp::HdfPyramid::HdfPyramid(HdfItem &item, const HdfPyramidOptions &options)
+    : HdfObject(SDATA, ITEM)
+    , aggregation(options.aggregation)
+    , minSize(options.minSize) {
+    if (item.getType() != SDATA) {
+        raiseException(INVALID_OPERATION);
+    }
+    dims = item.getDims();
+    if (dims.empty() || minSize < 1) {
+        raiseException(INVALID_RANGES);
+    }
+    for (const auto &dim : dims) {
+        if (dim <= 0) {
+            raiseException(INVALID_RANGES);
+        }
+    }
+    int32 size = largerOfFirstTwo(dims);
+    for (size_t level = 0; size > minSize && level < MAX_LEVELS; ++level) {
+        levelDims.push_back(reduceDims(dims, (std::int64_t)2 << level));
+        size = largerOfFirstTwo(levelDims.back());
+    }
+    levels.resize(levelDims.size());
+    LevelBuilder builder{item, dims, aggregation, levelDims, levels};
+    if (!dispatchNumberType(item.getDataType(), builder)) {
+        raiseException(INVALID_DATA_TYPE);
+    }
+}
+hdf4cpp::HdfPyramid::HdfPyramid(const std::string &path)
+    : HdfObject(SDATA, ITEM) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(CACHE_MAGIC)];
+    std::uint64_t keySize, rank, levelCount;
+    int32 storedAggregation;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) ||
+        !readValue(in, keySize) || keySize > (1 << 20)) {
+        raiseException(READ_FAIL);
+    }
+    key.resize((size_t)keySize);
+    if (!in.read(&key[0], (std::streamsize)keySize) || !readValue(in, storedAggregation) ||
+        !readValue(in, minSize) || !readValue(in, rank) || !rank || rank > MAX_DIMENSION ||
+        !readValues(in, dims, (size_t)rank) || !readValue(in, levelCount) || levelCount > MAX_LEVELS) {
+        raiseException(READ_FAIL);
+    }
+    aggregation = (Aggregation)storedAggregation;
+    for (std::uint64_t level = 0; level < levelCount; ++level) {
+        std::vector<int32> shape;
+        if (!readValues(in, shape, (size_t)rank)) {
+            raiseException(READ_FAIL);
+        }
+        if (shape != reduceDims(dims, (std::int64_t)2 << level)) {
+            raiseException(READ_FAIL);
+        }
+        levelDims.push_back(shape);
+        levels.push_back(std::vector<float64>());
+        if (!readValues(in, levels.back(), volumeOf(shape))) {
+            raiseException(READ_FAIL);
+        }
+    }
+}
+hdf4cpp::HdfPyramid hdf4cpp::HdfPyramid::open(HdfItem &item,
+                                              const std::string &sourcePath,
+                                              const std::string &cacheDirectory,
+                                              const HdfPyramidOptions &options) {
+    std::string key = getCacheKey(item, sourcePath, options);
+    std::string path = cachePathOf(cacheDirectory, key);
+    if (std::ifstream(path, std::ios::binary)) {
+        try {
+            HdfPyramid pyramid(path);
+            if (pyramid.key == key) {
+                return pyramid;
+            }
+        } catch (const HdfException &) {
+            // an outdated or damaged cache file is rebuilt
+        }
+    }
+    HdfPyramid pyramid(item, options);
+    pyramid.key = key;
+    pyramid.save(path);
+    return pyramid;
+}
+std::string hdf4cpp::HdfPyramid::getCachePath(HdfItem &item,
+                                              const std::string &sourcePath,
+                                              const std::string &cacheDirectory,
+                                              const HdfPyramidOptions &options) {
+    return cachePathOf(cacheDirectory, getCacheKey(item, sourcePath, options));
+}
+void hdf4cpp::HdfPyramid::save(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    writeValue(out, (std::uint64_t)key.size());
+    out.write(key.data(), key.size());
+    writeValue(out, (int32)aggregation);
+    writeValue(out, minSize);
+    writeValue(out, (std::uint64_t)dims.size());
+    writeValues(out, dims);
+    writeValue(out, (std::uint64_t)levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+        writeValues(out, levelDims[level]);
+        writeValues(out, levels[level]);
+    }
+    if (!out) {
+        raiseException(WRITE_FAIL);
+    }
+}
+const std::vector<int32> &hdf4cpp::HdfPyramid::getDims() const {
+    return dims;
+}
+size_t hdf4cpp::HdfPyramid::getLevelCount() const {
+    return levels.size();
+}
+const std::vector<int32> &hdf4cpp::HdfPyramid::getLevelDims(size_t level) const {
+    if (level >= levels.size()) {
+        raiseException(OUT_OF_RANGE);
+    }
+    return levelDims[level];
+}
+int32 hdf4cpp::HdfPyramid::getFactor(size_t level) const {
+    if (level >= levels.size()) {
+        raiseException(OUT_OF_RANGE);
+    }
+    return 2 << level;
+}
+size_t hdf4cpp::HdfPyramid::getNearestLevel(float64 scale) const {
+    if (levels.empty()) {
+        raiseException(INVALID_OPERATION);
+    }
+    size_t level = 0;
+    while (level + 1 < levels.size() && getFactor(level + 1) <= scale) {
+        ++level;
+    }
+    return level;
+}
+void hdf4cpp::HdfPyramid::read(std::vector<float64> &dest, size_t level, std::vector<Range> ranges) const {
+    const std::vector<int32> &shape = getLevelDims(level);
+    Range::fill(ranges, shape);
+    if (ranges.size() != shape.size()) {
+        raiseException(INVALID_RANGES);
+    }
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (!ranges[i].check(shape[i])) {
+            raiseException(INVALID_RANGES);
+        }
+    }
+    copyWindow(levels[level].data(), shape, ranges, dest);
+}
+std::pair<size_t, std::vector<hdf4cpp::Range>>
+hdf4cpp::HdfPyramid::readWindow(std::vector<float64> &dest, std::vector<Range> window, float64 scale) const {
+    size_t level = getNearestLevel(scale);
+    int32 factor = getFactor(level);
+    Range::fill(window, dims);
+    if (window.size() != dims.size()) {
+        raiseException(INVALID_RANGES);
+    }
+    std::vector<Range> ranges;
+    for (size_t i = 0; i < window.size(); ++i) {
+        if (!window[i].check(dims[i])) {
+            raiseException(INVALID_RANGES);
+        }
+        if (i < 2) {
+            // the window covers every index from begin to the last index read
+            std::int64_t span = window[i].quantity ? (std::int64_t)(window[i].quantity - 1) * window[i].stride + 1 : 0;
+            int32 begin = window[i].begin / factor;
+            int32 end = (int32)((window[i].begin + span + factor - 1) / factor);
+            ranges.push_back(Range(begin, end - begin));
+        } else {
+            ranges.push_back(window[i]);
+        }
+    }
+    read(dest, level, ranges);
+    return std::make_pair(level, ranges);
+}
+std::string
+hdf4cpp::HdfPyramid::getCacheKey(HdfItem &item, const std::string &sourcePath, const HdfPyramidOptions &options) {
+#ifdef _WIN32
+    struct _stat status;
+    if (_stat(sourcePath.c_str(), &status)) {
+#else
+    struct stat status;
+    if (stat(sourcePath.c_str(), &status)) {
+#endif
+        throw HdfException(HFILE, FILE, READ_FAIL);
+    }
+    std::ostringstream key;
+    key << sourcePath << '\n'
+        << (long long)status.st_mtime << ' ' << (long long)status.st_size << '\n'
+        << item.getName() << ' ' << item.getRef() << ' ' << item.getDataType();
+    for (const auto &dim : item.getDims()) {
+        key << ' ' << dim;
+    }
+    key << '\n' << (int)options.aggregation << ' ' << options.minSize;
+    return key.str();
+}
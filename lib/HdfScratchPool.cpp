@@ -0,0 +1,87 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfScratchPool.h>
+
+namespace {
+thread_local hdf4cpp::HdfScratchPool *installedPool = nullptr;
+}
+
+hdf4cpp::HdfScratchPool::Buffer::Buffer(HdfScratchPool *pool, std::unique_ptr<uint8[]> block, size_t capacity)
+    : pool(pool)
+    , block(std::move(block))
+    , capacity(capacity) {
+}
+hdf4cpp::HdfScratchPool::Buffer::Buffer(Buffer &&other) noexcept
+    : pool(other.pool)
+    , block(std::move(other.block))
+    , capacity(other.capacity) {
+    other.capacity = 0;
+}
+hdf4cpp::HdfScratchPool::Buffer::~Buffer() {
+    if (block) {
+        pool->release(std::move(block), capacity);
+    }
+}
+hdf4cpp::HdfScratchPool::Scope::Scope(HdfScratchPool &pool)
+    : previous(installedPool) {
+    installedPool = &pool;
+}
+hdf4cpp::HdfScratchPool::Scope::~Scope() {
+    installedPool = previous;
+}
+hdf4cpp::HdfScratchPool::HdfScratchPool(size_t maxSize)
+    : maxSize(maxSize) {
+}
+hdf4cpp::HdfScratchPool::Buffer hdf4cpp::HdfScratchPool::acquire(size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // best fit, so the small requests do not hold on to the big buffers
+        size_t best = blocks.size();
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            if (blocks[i].first >= size && (best == blocks.size() || blocks[i].first < blocks[best].first)) {
+                best = i;
+            }
+        }
+        if (best != blocks.size()) {
+            size_t capacity = blocks[best].first;
+            std::unique_ptr<uint8[]> block = std::move(blocks[best].second);
+            blocks.erase(blocks.begin() + best);
+            kept -= capacity;
+            return Buffer(this, std::move(block), capacity);
+        }
+        ++allocations;
+    }
+    // round up to a power of two, so slightly growing requests can reuse the buffer
+    size_t capacity = 64;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+    return Buffer(this, std::unique_ptr<uint8[]>(new uint8[capacity]), capacity);
+}
+void hdf4cpp::HdfScratchPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    blocks.clear();
+    kept = 0;
+}
+size_t hdf4cpp::HdfScratchPool::getAllocationCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocations;
+}
+size_t hdf4cpp::HdfScratchPool::getKeptSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return kept;
+}
+hdf4cpp::HdfScratchPool &hdf4cpp::HdfScratchPool::current() {
+    static thread_local HdfScratchPool local;
+    return installedPool ? *installedPool : local;
+}
+void hdf4cpp::HdfScratchPool::release(std::unique_ptr<uint8[]> block, size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // kept never exceeds maxSize, a block which does not fit is freed by going out of scope
+    if (capacity <= maxSize - kept) {
+        kept += capacity;
+        blocks.emplace_back(capacity, std::move(block));
+    }
+}
@@ -0,0 +1,79 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfThreadPool.h>
+
+#include <algorithm>
+
+hdf4cpp::HdfThreadPool::HdfThreadPool(size_t threads) {
+    if (!threads) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&HdfThreadPool::work, this);
+    }
+}
+hdf4cpp::HdfThreadPool::~HdfThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+size_t hdf4cpp::HdfThreadPool::size() const {
+    return workers.size();
+}
+std::future<void> hdf4cpp::HdfThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> future = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(packaged));
+    }
+    condition.notify_one();
+    return future;
+}
+void hdf4cpp::HdfThreadPool::work() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+hdf4cpp::HdfTaskWindow::HdfTaskWindow(HdfThreadPool &pool, size_t limit)
+    : pool(pool)
+    , limit(std::max<size_t>(1, limit)) {
+}
+hdf4cpp::HdfTaskWindow::~HdfTaskWindow() {
+    for (auto &future : pending) {
+        future.wait();
+    }
+}
+void hdf4cpp::HdfTaskWindow::submit(std::function<void()> task) {
+    if (pending.size() >= limit) {
+        std::future<void> oldest = std::move(pending.front());
+        pending.pop_front();
+        oldest.get();
+    }
+    pending.push_back(pool.submit(std::move(task)));
+}
+void hdf4cpp::HdfTaskWindow::wait() {
+    while (!pending.empty()) {
+        std::future<void> oldest = std::move(pending.front());
+        pending.pop_front();
+        oldest.get();
+    }
+}
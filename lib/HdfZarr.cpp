@@ -0,0 +1,262 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+
+#include <hdf4cpp/HdfAttribute.h>
+#include <hdf4cpp/HdfBatch.h>
+#include <hdf4cpp/HdfExport.h>
+#include <hdf4cpp/HdfTypeTraits.h>
+#include <hdf4cpp/HdfZarr.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+bool makeDirectory(const std::string &path) {
+#ifdef _WIN32
+    return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+std::string jsonString(const std::string &text) {
+    std::string json = "\"";
+    for (const auto &c : text) {
+        switch (c) {
+        case '"':
+            json += "\\\"";
+            break;
+        case '\\':
+            json += "\\\\";
+            break;
+        case '\n':
+            json += "\\n";
+            break;
+        case '\t':
+            json += "\\t";
+            break;
+        default:
+            if ((unsigned char)c >= 0x20) {
+                json += c;
+            }
+        }
+    }
+    return json + "\"";
+}
+
+template <class T> typename std::enable_if<std::is_integral<T>::value, std::string>::type jsonNumber(T value) {
+    return std::to_string(+value);
+}
+
+/// Zarr encodes the special floating point values as strings
+template <class T> typename std::enable_if<std::is_floating_point<T>::value, std::string>::type jsonNumber(T value) {
+    if (std::isnan(value)) {
+        return "\"NaN\"";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "\"Infinity\"" : "\"-Infinity\"";
+    }
+    std::ostringstream out;
+    out.precision(std::numeric_limits<T>::max_digits10);
+    out << value;
+    return out.str();
+}
+
+/// Reads an attribute as a JSON value: text as a string, one number as a scalar, more numbers as an array
+struct AttributeReader {
+    hdf4cpp::HdfAttribute &attribute;
+    std::string &json;
+    std::vector<uint8> &first;
+
+    template <class T> void operator()(hdf4cpp::HdfTypeTag<T>) {
+        std::vector<T> values;
+        attribute.get(values);
+        if (hdf4cpp::isTextNumberType(attribute.getDataType())) {
+            std::string text(values.begin(), values.end());
+            json = jsonString(text.substr(0, text.find('\0')));
+            return;
+        }
+        if (!values.empty()) {
+            first.resize(sizeof(T));
+            std::memcpy(first.data(), &values.front(), sizeof(T));
+        }
+        if (values.size() == 1) {
+            json = jsonNumber(values.front());
+            return;
+        }
+        json = "[";
+        for (size_t i = 0; i < values.size(); ++i) {
+            json += (i ? ", " : "") + jsonNumber(values[i]);
+        }
+        json += "]";
+    }
+};
+}
+
+/// Splits the bands into chunks and queues their compression, instantiated once per number type
+struct hdf4cpp::HdfZarrExporter::ChunkWriter {
+    HdfZarrExporter *exporter;
+    std::string directory;
+    std::vector<int32> dims;
+    std::vector<int32> chunks;
+    /// The bytes of the fill value, empty if the dataset has none
+    std::vector<uint8> fill;
+    int32 row;
+
+    template <class T> void operator()(std::vector<T> &band, int32 rows) {
+        std::shared_ptr<std::vector<T>> data = std::make_shared<std::vector<T>>(std::move(band));
+        T fillValue{};
+        if (fill.size() == sizeof(T)) {
+            std::memcpy(&fillValue, fill.data(), sizeof(T));
+        }
+
+        HdfBox outer;
+        outer.begin.assign(dims.size(), 0);
+        outer.count = dims;
+        outer.begin[0] = row;
+        outer.count[0] = rows;
+
+        // the band holds one row of chunks, the chunk grid is walked over the other dimensions
+        std::vector<int32> grid(dims.size(), 0);
+        grid[0] = row / chunks[0];
+        while (true) {
+            HdfBox chunk, inner;
+            std::string key;
+            for (size_t i = 0; i < dims.size(); ++i) {
+                chunk.begin.push_back(grid[i] * chunks[i]);
+                chunk.count.push_back(chunks[i]);
+                inner.begin.push_back(chunk.begin[i]);
+                inner.count.push_back(std::min(chunks[i], dims[i] - chunk.begin[i]));
+                key += (i ? "." : "") + std::to_string(grid[i]);
+            }
+            HdfZarrExporter *writer = exporter;
+            std::string path = directory + "/" + key;
+            exporter->window.submit([writer, path, data, chunk, inner, outer, fillValue]() {
+                std::vector<T> padded(chunk.volume(), fillValue);
+                if (inner.count == chunk.count) {
+                    copyBox(data->data(), outer, padded.data(), inner);
+                } else {
+                    std::vector<T> packed(inner.volume());
+                    copyBox(data->data(), outer, packed.data(), inner);
+                    pasteBox(packed.data(), inner, padded.data(), chunk);
+                }
+                writer->writeChunk(path, reinterpret_cast<const uint8 *>(padded.data()), padded.size() * sizeof(T));
+            });
+
+            size_t dim = dims.size();
+            while (--dim > 0) {
+                if (++grid[dim] * chunks[dim] < dims[dim]) {
+                    break;
+                }
+                grid[dim] = 0;
+            }
+            if (dim == 0) {
+                break;
+            }
+        }
+        row += rows;
+    }
+};
+
+hdf4cpp::HdfZarrExporter::HdfZarrExporter(const HdfZarrOptions &options)
+    : HdfObject(HFILE, FILE)
+    , options(options)
+    , pool(options.threads)
+    , window(pool, options.maxPendingChunks ? options.maxPendingChunks : 2 * pool.size()) {
+}
+void hdf4cpp::HdfZarrExporter::exportDataset(HdfItem &item, const std::string &directory) {
+    std::vector<int32> dims = item.getDims();
+    int32 dataType = item.getDataType();
+    std::string dtype = npyDescr(dataType);
+    if (dtype.empty()) {
+        raiseException(INVALID_DATA_TYPE);
+    }
+    size_t rowSize = numberTypeSize(dataType);
+    for (size_t i = 1; i < dims.size(); ++i) {
+        rowSize *= std::max<int32>(1, dims[i]);
+    }
+
+    std::vector<int32> chunks = options.chunks;
+    for (size_t i = chunks.size(); i < dims.size(); ++i) {
+        chunks.push_back(i ? dims[i] : (int32)std::max<size_t>(1, STREAM_BUFFER_SIZE / rowSize));
+    }
+    chunks.resize(dims.size());
+    for (size_t i = 0; i < dims.size(); ++i) {
+        chunks[i] = std::max<int32>(1, std::min(chunks[i], dims[i]));
+    }
+
+    // the attributes, the fill value is also used for padding the edge chunks
+    std::ostringstream attributes;
+    std::string fillJson = "null";
+    std::vector<uint8> fill;
+    attributes << "{";
+    std::vector<std::string> names = item.getAttributeNames();
+    for (size_t i = 0; i < names.size(); ++i) {
+        HdfAttribute attribute = item.getAttribute(names[i]);
+        std::string json;
+        std::vector<uint8> first;
+        AttributeReader reader{attribute, json, first};
+        if (!dispatchNumberType(attribute.getDataType(), reader)) {
+            json = "null";
+        }
+        if (names[i] == "_FillValue" && !isTextNumberType(dataType) && attribute.getDataType() == dataType) {
+            fillJson = json;
+            fill = first;
+        }
+        attributes << (i ? ",\n  " : "\n  ") << jsonString(names[i]) << ": " << json;
+    }
+    attributes << (names.empty() ? "}\n" : "\n}\n");
+
+    std::ostringstream array;
+    array << "{\n  \"chunks\": [";
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        array << (i ? ", " : "") << chunks[i];
+    }
+    array << "],\n  \"compressor\": {\"id\": \"zlib\", \"level\": " << options.level << "},\n  \"dtype\": \"" << dtype
+          << "\",\n  \"fill_value\": " << fillJson << ",\n  \"filters\": null,\n  \"order\": \"C\",\n  \"shape\": [";
+    for (size_t i = 0; i < dims.size(); ++i) {
+        array << (i ? ", " : "") << dims[i];
+    }
+    array << "],\n  \"zarr_format\": 2\n}\n";
+
+    if (!makeDirectory(directory)) {
+        raiseException(WRITE_FAIL);
+    }
+    writeFile(directory + "/.zarray", array.str());
+    writeFile(directory + "/.zattrs", attributes.str());
+
+    ChunkWriter writer{this, directory, dims, chunks, fill, 0};
+    item.readAnyBands(writer, (size_t)chunks[0] * rowSize);
+}
+void hdf4cpp::HdfZarrExporter::wait() {
+    window.wait();
+}
+void hdf4cpp::HdfZarrExporter::writeFile(const std::string &path, const std::string &content) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), content.size());
+    if (!out) {
+        raiseException(WRITE_FAIL);
+    }
+}
+void hdf4cpp::HdfZarrExporter::writeChunk(const std::string &path, const uint8 *data, size_t size) const {
+    uLongf length = compressBound((uLong)size);
+    std::vector<Bytef> compressed(length);
+    if (compress2(compressed.data(), &length, data, (uLong)size, options.level) != Z_OK) {
+        raiseException("zlib compression failed");
+    }
+    writeFile(path, std::string(reinterpret_cast<const char *>(compressed.data()), length));
+}
@@ -5,6 +5,19 @@
 #include <gtest/gtest.h>
 #include <hdf4cpp/hdf.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <zlib.h>
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
 using namespace hdf4cpp;
 
 class HdfFileTest : public ::testing::Test {
@@ -96,6 +109,26 @@ TEST_F(HdfFileTest, ReadDataInRange) {
     }
 }
 
+TEST_F(HdfFileTest, ReadDataInStridedRange) {
+    HdfItem item = file.get("Data");
+    std::vector<int32> vec;
+    item.read(vec, std::vector<Range>({Range(0, 2, 2), Range(1, 1)}));
+    ASSERT_EQ(vec, std::vector<int32>({2, 8}));
+    item.read(vec, std::vector<Range>({Range(1, 1), Range(0, 3, 1)}));
+    ASSERT_EQ(vec, std::vector<int32>({4, 5, 6}));
+    ASSERT_THROW(item.read(vec, std::vector<Range>({Range(0, 3, 2), Range(0, 3)})), HdfException);
+}
+
+TEST(HdfRangeTest, QuantityIsTheNumberOfValues) {
+    ASSERT_EQ(Range(0, 3, 2).size(), 3);
+    ASSERT_TRUE(Range(0, 2, 2).check(3));
+    ASSERT_FALSE(Range(0, 3, 2).check(3));
+    ASSERT_TRUE(Range(1, 3, 2).check(6));
+    ASSERT_FALSE(Range(1, 3, 2).check(5));
+    ASSERT_TRUE(Range(3, 0, 2).check(3));
+    ASSERT_FALSE(Range(0, 1, 0).check(3));
+}
+
 TEST_F(HdfFileTest, ReadInvalidDatasetAttribute) {
     HdfItem item = file.get("Data");
     ASSERT_THROW(HdfAttribute attribute = item.getAttribute("Attribute"), HdfException);
@@ -233,3 +266,1331 @@ TEST_F(HdfFileTest, VdataDestroyer) {
     attribute.get(vec);
     ASSERT_EQ(vec, std::vector<int32>({1, 2, 3, 3, 2, 1}));
 }
+
+TEST_F(HdfFileTest, DatasetExactTypeMismatch) {
+    HdfItem item = file.get("DataWithAttributes");
+    std::vector<int32> vec;
+    try {
+        item.read(vec);
+        ASSERT_TRUE(false);
+    } catch (const HdfException &exception) {
+        ASSERT_EQ(exception.getExceptionType(), TYPE_MISMATCH);
+    }
+}
+
+TEST_F(HdfFileTest, AttributeExactTypeMismatch) {
+    HdfAttribute attribute = file.get("DataWithAttributes").getAttribute("Integer");
+    std::vector<float32> vec;
+    ASSERT_THROW(attribute.get(vec), HdfException);
+}
+
+struct SumVisitor {
+    double sum = 0;
+    bool floating = false;
+
+    template <class T> void operator()(const std::vector<T> &vec) {
+        floating = std::is_floating_point<T>::value;
+        for (const auto &value : vec) {
+            sum += value;
+        }
+    }
+};
+
+TEST_F(HdfFileTest, ReadAny) {
+    SumVisitor visitor;
+    file.get("Data").readAny(visitor);
+    ASSERT_FALSE(visitor.floating);
+    ASSERT_EQ(visitor.sum, 45);
+
+    SumVisitor floatVisitor;
+    file.get("DataWithAttributes").readAny(floatVisitor, std::vector<Range>({Range(1, 1)}));
+    ASSERT_TRUE(floatVisitor.floating);
+    ASSERT_NEAR(floatVisitor.sum, 3.3, 1e-5);
+}
+
+TEST_F(HdfFileTest, ReadAggregatedMean) {
+    HdfItem item = file.get("Data");
+    std::vector<float64> vec;
+    item.readAggregated(vec, {2, 2}, AGGREGATE_MEAN);
+    ASSERT_EQ(vec, std::vector<float64>({3.0, 4.5, 7.5, 9.0}));
+}
+
+TEST_F(HdfFileTest, ReadAggregatedMaxInRange) {
+    HdfItem item = file.get("Data");
+    std::vector<int32> vec;
+    item.readAggregated(vec, {1, 2}, AGGREGATE_MAX, std::vector<Range>({Range(1, 2)}));
+    ASSERT_EQ(vec, std::vector<int32>({5, 6, 8, 9}));
+}
+
+TEST_F(HdfFileTest, Statistics) {
+    HdfItem item = file.get("Data");
+    HdfStatisticsOptions options;
+    options.bins = 3;
+    options.histogramMin = 1.0;
+    options.histogramMax = 10.0;
+    options.threads = 2;
+    HdfStatistics statistics = item.getStatistics(options);
+    ASSERT_EQ(statistics.count, 9u);
+    ASSERT_EQ(statistics.validCount, 9u);
+    ASSERT_EQ(statistics.min, 1.0);
+    ASSERT_EQ(statistics.max, 9.0);
+    ASSERT_EQ(statistics.sum, 45.0);
+    ASSERT_EQ(statistics.mean(), 5.0);
+    ASSERT_EQ(statistics.histogram, std::vector<std::uint64_t>({3, 3, 3}));
+}
+
+TEST_F(HdfFileTest, StatisticsWithSharedPool) {
+    HdfThreadPool pool(2);
+    HdfStatisticsOptions options;
+    options.pool = &pool;
+    HdfStatistics statistics = file.get("Data").getStatistics(options);
+    ASSERT_EQ(statistics.count, 9u);
+    ASSERT_EQ(statistics.sum, 45.0);
+    statistics = file.get("DataWithAttributes").getStatistics(options, std::vector<Range>({Range(2, 1)}));
+    ASSERT_EQ(statistics.count, 3u);
+    ASSERT_NEAR(statistics.sum, 6.3, 1e-5);
+}
+
+TEST_F(HdfFileTest, StatisticsInRange) {
+    HdfItem item = file.get("DataWithAttributes");
+    HdfStatistics statistics = item.getStatistics(HdfStatisticsOptions(), std::vector<Range>({Range(2, 1)}));
+    ASSERT_EQ(statistics.count, 3u);
+    ASSERT_NEAR(statistics.sum, 6.3, 1e-5);
+    ASSERT_NEAR(statistics.min, 2.0, 1e-6);
+    ASSERT_NEAR(statistics.max, 2.2, 1e-6);
+}
+
+TEST_F(HdfFileTest, ReadBatch) {
+    HdfItem item = file.get("Data");
+    std::vector<std::vector<int32>> vecs;
+    item.readBatch(vecs,
+                   {{Range(0, 2), Range(0, 2)},
+                    {Range(1, 2), Range(1, 2)},
+                    {Range(2, 1)},
+                    {Range(0, 2, 2), Range(0, 2, 2)}});
+    ASSERT_EQ(vecs.size(), 4);
+    ASSERT_EQ(vecs[0], std::vector<int32>({1, 2, 4, 5}));
+    ASSERT_EQ(vecs[1], std::vector<int32>({5, 6, 8, 9}));
+    ASSERT_EQ(vecs[2], std::vector<int32>({7, 8, 9}));
+    ASSERT_EQ(vecs[3], std::vector<int32>({1, 3, 7, 9}));
+}
+
+TEST(HdfBatchTest, CoalescesAdjacentRequests) {
+    std::vector<HdfBox> boxes = {{{0, 0}, {2, 2}}, {{2, 0}, {2, 2}}, {{100, 100}, {1, 1}}};
+    HdfReadPlan plan = planCoalescedReads(boxes);
+    ASSERT_EQ(plan.reads.size(), 2);
+    ASSERT_EQ(plan.readOf, std::vector<size_t>({0, 0, 1}));
+    ASSERT_EQ(plan.reads[0].count, std::vector<int32>({4, 2}));
+}
+
+TEST(HdfBatchTest, KeepsCrossingThinRequestsApart) {
+    // a row and a column span a 100x100 box, which is far larger than 2 times their 200 requested values
+    std::vector<HdfBox> boxes = {{{50, 0}, {1, 100}}, {{0, 50}, {100, 1}}};
+    HdfReadPlan plan = planCoalescedReads(boxes);
+    ASSERT_EQ(plan.reads.size(), 2);
+    plan = planCoalescedReads(boxes, 100.0);
+    ASSERT_EQ(plan.reads.size(), 1);
+}
+
+TEST(HdfScratchPoolTest, ReusesBuffers) {
+    HdfScratchPool pool;
+    {
+        HdfScratchPool::Buffer buffer = pool.acquire(100);
+        ASSERT_GE(buffer.size(), 100u);
+    }
+    {
+        HdfScratchPool::Buffer buffer = pool.acquire(80);
+        ASSERT_GE(buffer.size(), 80u);
+    }
+    ASSERT_EQ(pool.getAllocationCount(), 1u);
+}
+
+TEST(HdfScratchPoolTest, KeepsAtMostMaxSize) {
+    HdfScratchPool pool(1024);
+    {
+        HdfScratchPool::Buffer small = pool.acquire(512);
+        HdfScratchPool::Buffer other = pool.acquire(512);
+        HdfScratchPool::Buffer large = pool.acquire(4096);
+    }
+    // the large buffer does not fit, so it is freed instead of kept
+    ASSERT_EQ(pool.getKeptSize(), 1024u);
+    {
+        HdfScratchPool::Buffer large = pool.acquire(4096);
+    }
+    ASSERT_EQ(pool.getAllocationCount(), 4u);
+    {
+        HdfScratchPool::Buffer small = pool.acquire(512);
+        ASSERT_EQ(pool.getKeptSize(), 512u);
+    }
+    ASSERT_EQ(pool.getAllocationCount(), 4u);
+    pool.clear();
+    ASSERT_EQ(pool.getKeptSize(), 0u);
+}
+
+TEST_F(HdfFileTest, ReadWithoutScratchAllocations) {
+    HdfScratchPool pool;
+    HdfScratchPool::Scope scope(pool);
+    HdfItem item = file.get("Vdata");
+    std::vector<std::vector<char>> vec;
+    item.read(vec, "name");
+    size_t allocations = pool.getAllocationCount();
+    for (int i = 0; i < 10; ++i) {
+        item.read(vec, "name");
+    }
+    ASSERT_EQ(pool.getAllocationCount(), allocations);
+
+    // the same for the batched reads of a dataset, which merge the requests in a scratch buffer
+    HdfItem data = file.get("Data");
+    std::vector<std::vector<int32>> values;
+    std::vector<std::vector<Range>> requests = {{Range(0, 2), Range(0, 2)}, {Range(1, 2), Range(1, 2)}};
+    data.readBatch(values, requests);
+    allocations = pool.getAllocationCount();
+    for (int i = 0; i < 10; ++i) {
+        data.readBatch(values, requests);
+    }
+    ASSERT_EQ(pool.getAllocationCount(), allocations);
+}
+
+template <class T> struct CountingAllocator : std::allocator<T> {
+    template <class U> struct rebind { typedef CountingAllocator<U> other; };
+    CountingAllocator() = default;
+    template <class U> CountingAllocator(const CountingAllocator<U> &) {
+    }
+    T *allocate(size_t n) {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+    static size_t allocations;
+};
+template <class T> size_t CountingAllocator<T>::allocations = 0;
+
+TEST_F(HdfFileTest, ReadWithAllocator) {
+    HdfItem item = file.get("Data");
+    std::vector<int32, CountingAllocator<int32>> vec;
+    item.read(vec);
+    item.read(vec);
+    ASSERT_EQ(std::vector<int32>(vec.begin(), vec.end()), std::vector<int32>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    ASSERT_EQ(CountingAllocator<int32>::allocations, 1u);
+}
+
+TEST_F(HdfFileTest, GroupRefs) {
+    HdfItem item = file.get("Group");
+    std::vector<HdfItemRef> refs = item.getRefs();
+    ASSERT_EQ(refs.size(), 2);
+    std::ostringstream out;
+    for (const auto &ref : refs) {
+        ASSERT_EQ(ref.getType(), SDATA);
+        out << ref.get().getName() << '*';
+    }
+    ASSERT_EQ(out.str(), "Data*DataWithAttributes*");
+    ASSERT_TRUE(file.get("Vdata").getRefs().empty());
+}
+
+TEST_F(HdfFileTest, FileRefs) {
+    std::vector<HdfItemRef> refs = file.getRefs();
+    ASSERT_FALSE(refs.empty());
+    ASSERT_EQ(refs.front().getType(), VGROUP);
+    ASSERT_EQ(refs.front().getTag(), DFTAG_VG);
+    ASSERT_EQ(refs.front().get().getName(), "Group");
+}
+
+TEST_F(HdfFileTest, Hierarchy) {
+    HdfHierarchy hierarchy(file);
+    ASSERT_FALSE(hierarchy.hasCycles());
+    size_t group = hierarchy.getRoots().front();
+    ASSERT_EQ(hierarchy.getNode(group).name, "Group");
+    std::ostringstream out;
+    for (const auto &child : hierarchy.getNode(group).children) {
+        out << hierarchy.getNode(child).name << '*';
+        const std::vector<size_t> &parents = hierarchy.getNode(child).parents;
+        ASSERT_NE(std::find(parents.begin(), parents.end(), group), parents.end());
+    }
+    ASSERT_EQ(out.str(), "Data*DataWithAttributes*");
+}
+
+TEST_F(HdfFileTest, HierarchyVisitWithPruning) {
+    HdfHierarchy hierarchy(file);
+    std::vector<std::string> visited;
+    hierarchy.visit([&](const HdfNode &node) {
+        visited.push_back(node.name);
+        return false;
+    });
+    ASSERT_EQ(visited.size(), hierarchy.getRoots().size());
+    ASSERT_EQ(visited.front(), "Group");
+}
+
+TEST_F(HdfFileTest, HierarchyVisitParallel) {
+    HdfHierarchy hierarchy(file);
+    std::atomic<size_t> count(0);
+    std::mutex namesMutex;
+    std::vector<std::string> names;
+    hierarchy.visitParallel(
+    [&](const HdfNode &, const HdfNodeAccess &access) {
+        ++count;
+        // the item is attached under the lock of the library
+        std::string name = access.withItem([](HdfItem &item) { return item.getName(); });
+        std::lock_guard<std::mutex> lock(namesMutex);
+        names.push_back(name);
+        return true;
+    },
+    4);
+    std::vector<std::string> sequential;
+    hierarchy.visit([&](const HdfNode &node) {
+        sequential.push_back(node.name);
+        return true;
+    });
+    ASSERT_EQ(count, sequential.size());
+    ASSERT_EQ(count, hierarchy.size());
+    std::sort(names.begin(), names.end());
+    std::sort(sequential.begin(), sequential.end());
+    ASSERT_EQ(names, sequential);
+}
+
+TEST_F(HdfFileTest, Parents) {
+    HdfItem data = file.get("Group").getRefs().front().get();
+    std::vector<HdfItemRef> parents = data.getParents();
+    ASSERT_EQ(parents.size(), 1);
+    ASSERT_EQ(parents.front().getType(), VGROUP);
+    ASSERT_EQ(parents.front().get().getName(), "Group");
+    ASSERT_EQ(data.getPath(), "/Group/Data");
+    ASSERT_TRUE(file.get("Group").getParents().empty());
+    ASSERT_EQ(file.get("Group").getPath(), "/Group");
+}
+
+TEST(HdfExportTest, NpyHeader) {
+    std::string header = npyHeader(DFNT_FLOAT32, {2, 3});
+    ASSERT_EQ(header.size() % 64, 0);
+    ASSERT_EQ(header.substr(1, 5), "NUMPY");
+    ASSERT_NE(header.find("'shape': (2, 3)"), std::string::npos);
+    ASSERT_NE(npyHeader(DFNT_INT16, {5}).find("'shape': (5,)"), std::string::npos);
+    ASSERT_EQ(header.back(), '\n');
+}
+
+TEST_F(HdfFileTest, ExportNpy) {
+    HdfItem item = file.get("Data");
+    std::string path = testing::TempDir() + "hdf4cpp_export.npy";
+    HdfExportOptions options;
+    options.bandSize = sizeof(int32); // one row per band
+    options.threads = 2;
+    HdfExporter exporter(options);
+    exporter.exportDataset(item, path);
+    exporter.wait();
+
+    std::ifstream in(path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::string header = npyHeader(item.getDataType(), item.getDims());
+    ASSERT_EQ(content.substr(0, header.size()), header);
+    std::vector<int32> data((content.size() - header.size()) / sizeof(int32));
+    std::copy(content.begin() + header.size(), content.end(), reinterpret_cast<char *>(data.data()));
+    ASSERT_EQ(data, std::vector<int32>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_F(HdfFileTest, ExportZarr) {
+    HdfItem item = file.get("Data");
+    std::string directory = testing::TempDir() + "hdf4cpp_export.zarr";
+    HdfZarrOptions options;
+    options.chunks = {2, 2};
+    options.threads = 2;
+    HdfZarrExporter exporter(options);
+    exporter.exportDataset(item, directory);
+    exporter.wait();
+
+    std::ifstream array(directory + "/.zarray");
+    std::string metadata((std::istreambuf_iterator<char>(array)), std::istreambuf_iterator<char>());
+    ASSERT_NE(metadata.find("\"chunks\": [2, 2]"), std::string::npos);
+    ASSERT_NE(metadata.find("\"shape\": [3, 3]"), std::string::npos);
+
+    std::ifstream in(directory + "/0.1", std::ios::binary);
+    std::string compressed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<int32> chunk(4);
+    uLongf length = chunk.size() * sizeof(int32);
+    ASSERT_EQ(uncompress(reinterpret_cast<Bytef *>(chunk.data()),
+                         &length,
+                         reinterpret_cast<const Bytef *>(compressed.data()),
+                         compressed.size()),
+              Z_OK);
+    ASSERT_EQ(chunk[0], 3);
+    ASSERT_EQ(chunk[2], 6);
+}
+
+TEST_F(HdfFileTest, Tiles) {
+    HdfItem item = file.get("Data");
+    HdfTileSequence<int32> tiles = item.tiles<int32>({2, 2});
+    ASSERT_EQ(tiles.size(), 4);
+    std::vector<std::vector<int32>> data;
+    for (const auto &tile : tiles) {
+        data.push_back(tile.data);
+    }
+    ASSERT_EQ(data.size(), 4);
+    ASSERT_EQ(data.front(), std::vector<int32>({1, 2, 4, 5}));
+    ASSERT_EQ(data.back(), std::vector<int32>({9}));
+}
+
+TEST_F(HdfFileTest, TilesStopEarly) {
+    HdfItem item = file.get("Data");
+    HdfBox found;
+    for (const auto &tile : item.tiles<int32>({1})) {
+        if (std::find(tile.data.begin(), tile.data.end(), 5) != tile.data.end()) {
+            found = tile.box;
+            break;
+        }
+    }
+    ASSERT_EQ(found.begin, std::vector<int32>({1, 0}));
+    ASSERT_EQ(found.count, std::vector<int32>({1, 3}));
+}
+
+TEST_F(HdfFileTest, RecordBatches) {
+    HdfItem item = file.get("Vdata");
+    std::vector<int32> ages;
+    std::vector<int32> firsts;
+    for (const auto &batch : item.records<int32>("age", 2)) {
+        firsts.push_back(batch.first);
+        ages.insert(ages.end(), batch.data.begin(), batch.data.end());
+    }
+    ASSERT_EQ(firsts, std::vector<int32>({0, 2}));
+    ASSERT_EQ(ages, std::vector<int32>({39, 19, 55}));
+}
+
+#if defined(HDF4CPP_COROUTINES) && defined(__cpp_impl_coroutine)
+TEST_F(HdfFileTest, GenerateTiles) {
+    HdfItem item = file.get("Data");
+    std::vector<int32> firsts;
+    for (auto &tile : generateTiles<int32>(item, {2, 2})) {
+        firsts.push_back(tile.data.front());
+    }
+    ASSERT_EQ(firsts, std::vector<int32>({1, 3, 7, 9}));
+}
+#endif
+
+TEST_F(HdfFileTest, Dimensions) {
+    HdfItem item = file.get("Data");
+    std::vector<HdfDimension> dimensions = item.getDimensions();
+    ASSERT_EQ(dimensions.size(), 2);
+    for (size_t i = 0; i < dimensions.size(); ++i) {
+        ASSERT_EQ(dimensions[i].getSize(), item.getDims()[i]);
+        ASSERT_FALSE(dimensions[i].getName().empty());
+    }
+    ASSERT_THROW(item.getDimension(2), HdfException);
+    ASSERT_THROW(file.get("Vdata").getDimensions(), HdfException);
+}
+
+TEST_F(HdfFileTest, ReadByCoordinates) {
+    HdfItem item = file.get("Data");
+    std::vector<int32> vec;
+    std::vector<Range> ranges = item.readByCoordinates(vec, {});
+    ASSERT_EQ(ranges.size(), 2);
+    ASSERT_EQ(ranges[0].quantity, 3);
+    ASSERT_EQ(vec, std::vector<int32>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    ASSERT_THROW(item.getCoordinateRanges({HdfInterval(), HdfInterval(), HdfInterval()}), HdfException);
+}
+
+TEST(HdfCoordinateIndexTest, Find) {
+    HdfCoordinateIndex increasing({0.0, 1.0, 1.0, 2.0, 5.0});
+    ASSERT_TRUE(increasing.isMonotonic());
+    Range range = increasing.find(HdfInterval(0.5, 2.0));
+    ASSERT_EQ(range.begin, 1);
+    ASSERT_EQ(range.quantity, 3);
+    ASSERT_EQ(increasing.find(HdfInterval(3.0, 4.0)).quantity, 0);
+
+    HdfCoordinateIndex decreasing({90.0, 45.0, 0.0, -45.0, -90.0});
+    ASSERT_TRUE(decreasing.isMonotonic());
+    range = decreasing.find(HdfInterval(-50.0, 10.0));
+    ASSERT_EQ(range.begin, 2);
+    ASSERT_EQ(range.quantity, 2);
+
+    HdfCoordinateIndex unordered({180.0, 190.0, -170.0, 5.0, std::nan("")});
+    ASSERT_FALSE(unordered.isMonotonic());
+    range = unordered.find(HdfInterval(-175.0, 185.0));
+    ASSERT_EQ(range.begin, 0);
+    ASSERT_EQ(range.quantity, 4);
+    ASSERT_EQ(unordered.find(HdfInterval(6.0, 7.0)).quantity, 0);
+    ASSERT_EQ(unordered.find(HdfInterval()).quantity, 4);
+}
+
+TEST(HdfCoordinateIndexTest, FindInManyBlocks) {
+    // a longitude scale crossing the antimeridian, the wide intervals match entries of many blocks
+    std::vector<float64> values;
+    for (int32 i = 0; i < 1000; ++i) {
+        values.push_back(std::fmod(150.0 + i * 0.37 + 180.0, 360.0) - 180.0);
+    }
+    HdfCoordinateIndex index(values);
+    ASSERT_FALSE(index.isMonotonic());
+    for (float64 min = -180.0; min < 180.0; min += 7.3) {
+        for (float64 width : {0.1, 1.0, 25.0, 200.0}) {
+            HdfInterval interval(min, min + width);
+            int32 first = -1, last = -1;
+            for (int32 i = 0; i < (int32)values.size(); ++i) {
+                if (interval.min <= values[i] && values[i] <= interval.max) {
+                    first = first < 0 ? i : first;
+                    last = i;
+                }
+            }
+            Range range = index.find(interval);
+            if (first < 0) {
+                ASSERT_EQ(range.quantity, 0);
+            } else {
+                ASSERT_EQ(range.begin, first);
+                ASSERT_EQ(range.quantity, last - first + 1);
+            }
+        }
+    }
+}
+
+TEST_F(HdfFileTest, GeolocationIndex) {
+    // the values 1..9 of Data are used as both latitude and longitude
+    HdfItem data = file.get("Data");
+    HdfGeolocationIndex index(data, data);
+    ASSERT_EQ(index.size(), 9);
+    HdfPixel pixel = index.nearest(HdfGeoPoint{5.1, 4.9});
+    ASSERT_EQ(pixel.row, 1);
+    ASSERT_EQ(pixel.column, 1);
+    ASSERT_LT(pixel.distance, 20.0);
+    ASSERT_FALSE(index.nearest(HdfGeoPoint{-45.0, 90.0}, 100.0).isValid());
+    std::vector<HdfPixel> near = index.withinRadius(HdfGeoPoint{5.0, 5.0}, 200.0);
+    ASSERT_EQ(near.size(), 3);
+    ASSERT_EQ(near[0].row * 3 + near[0].column, 4);
+
+    std::string path = testing::TempDir() + "hdf4cpp_geolocation_index.idx";
+    index.save(path);
+    HdfGeolocationIndex loaded(path);
+    std::vector<HdfGeoPoint> points = {HdfGeoPoint{9.0, 9.0}, HdfGeoPoint{1.2, 1.0}, HdfGeoPoint{-60.0, 0.0}};
+    std::vector<HdfPixel> pixels = loaded.nearest(points, 500.0);
+    std::vector<int32> values;
+    loaded.extract(data, pixels, values);
+    ASSERT_EQ(values, std::vector<int32>({9, 1, 0}));
+    std::remove(path.c_str());
+}
+
+TEST_F(HdfFileTest, GeolocationSidecarKey) {
+    HdfItem data = file.get("Data");
+    std::string source = testing::TempDir() + "hdf4cpp_geolocation_source.hdf";
+    std::string sidecar = testing::TempDir() + "hdf4cpp_geolocation.idx";
+    {
+        std::ifstream in(TEST_DATA_PATH "small_test.hdf", std::ios::binary);
+        std::ofstream out(source, std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    }
+    auto contents = [&sidecar]() {
+        std::ifstream in(sidecar, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+
+    // a sidecar of the same dimensions which was not written for the source is rebuilt
+    HdfGeolocationIndex(data, data).save(sidecar);
+    std::string stale = contents();
+    HdfGeolocationIndex index = HdfGeolocationIndex::open(data, data, source, sidecar);
+    ASSERT_EQ(index.size(), 9);
+    std::string keyed = contents();
+    ASSERT_NE(keyed, stale);
+    ASSERT_NE(keyed.find(source), std::string::npos);
+    HdfGeolocationIndex::open(data, data, source, sidecar);
+    ASSERT_EQ(contents(), keyed);
+
+    // a changed source file makes the sidecar stale, though the dimensions are the same
+    std::ofstream(source, std::ios::binary | std::ios::app) << "changed";
+    index = HdfGeolocationIndex::open(data, data, source, sidecar);
+    ASSERT_NE(contents(), keyed);
+    HdfPixel pixel = index.nearest(HdfGeoPoint{5.1, 4.9});
+    ASSERT_EQ(pixel.row * 3 + pixel.column, 4);
+    std::remove(sidecar.c_str());
+    std::remove(source.c_str());
+}
+
+TEST_F(HdfFileTest, ImageOperationsOnOtherItems) {
+    ASSERT_NE(file.getGRId(), FAIL);
+    HdfItem item = file.get("Data");
+    std::vector<int32> vec;
+    ASSERT_THROW(item.readImage(vec, {}, INTERLACE_COMPONENT), HdfException);
+    ASSERT_THROW(item.getComponentCount(), HdfException);
+    ASSERT_THROW(item.hasPalette(), HdfException);
+    for (auto it = file.begin(); it != file.end(); ++it) {
+        ASSERT_NE((*it).getType(), GRIMAGE);
+    }
+}
+
+TEST_F(HdfFileTest, ArrayView) {
+    HdfItem item = file.get("Data");
+    HdfArrayView<int32> view(item);
+    ASSERT_EQ(view.getShape(), std::vector<int32>({3, 3}));
+    std::vector<int32> vec;
+    view.transpose().slice(0, 1, 2).read(vec);
+    ASSERT_EQ(vec, std::vector<int32>({2, 5, 8, 3, 6, 9}));
+    view.slice(0, 0, 2, 2).at(1, 2).read(vec);
+    ASSERT_EQ(vec, std::vector<int32>({3, 9}));
+    int32 buffer[1];
+    ASSERT_THROW(view.at(0, 1).read(buffer, 1), HdfException);
+    ASSERT_THROW(view.slice(1, 2, 2), HdfException);
+    ASSERT_THROW(HdfArrayView<float32>{item}, HdfException);
+}
+
+TEST_F(HdfFileTest, TryGet) {
+    HdfResult<HdfItem> missing = file.tryGet("InvalidKey");
+    ASSERT_FALSE(missing);
+    ASSERT_EQ(missing.getError().exceptionType, INVALID_ID);
+    ASSERT_THROW(missing.value(), HdfException);
+    HdfResult<HdfItem> item = file.tryGet("DataWithAttributes");
+    ASSERT_TRUE(item);
+    ASSERT_FALSE(item->tryGetAttribute("Attribute"));
+    HdfResult<HdfAttribute> attribute = item->tryGetAttribute("Integer");
+    ASSERT_TRUE(attribute);
+    std::vector<std::string> names;
+    ASSERT_EQ(attribute->tryGet(names).getError().exceptionType, TYPE_MISMATCH);
+    std::vector<float32> vec;
+    HdfStatus status = item->tryRead(vec, std::vector<Range>({Range(0, 1), Range(0, 1), Range(0, 1)}));
+    ASSERT_EQ(status.getError().exceptionType, INVALID_RANGES);
+    ASSERT_TRUE(item->tryRead(vec, std::vector<Range>({Range(2, 1), Range(0, 2)})));
+    ASSERT_EQ(vec, std::vector<float32>({2.0f, 2.1f}));
+    ASSERT_EQ(file.get("Group").tryRead(vec).getError().exceptionType, INVALID_OPERATION);
+}
+
+TEST_F(HdfFileTest, MemoryBudget) {
+    HdfItem item = file.get("Data");
+    file.getMemoryBudget().setLimit(2 * 3 * sizeof(int32));
+    std::vector<int32> vec;
+    ASSERT_EQ(item.tryRead(vec).getError().exceptionType, OUT_OF_BUDGET);
+    std::vector<int32> rows;
+    item.readStreamed<int32>([&](std::vector<int32> &band, int32 count) {
+        ASSERT_LE(count, 2);
+        rows.insert(rows.end(), band.begin(), band.end());
+    });
+    ASSERT_EQ(rows, std::vector<int32>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    HdfMemoryStats stats = file.getMemoryBudget().getStats();
+    ASSERT_EQ(stats.inUse, 0);
+    ASSERT_EQ(stats.peak, 2 * 3 * sizeof(int32));
+    ASSERT_EQ(stats.rejected, 1);
+    file.getMemoryBudget().setLimit(0);
+    ASSERT_NO_THROW(item.read(vec));
+}
+
+TEST_F(HdfFileTest, MemoryBudgetCoversBatchesAndViews) {
+    HdfItem item = file.get("Data");
+    file.getMemoryBudget().setLimit(2 * sizeof(int32));
+    std::vector<std::vector<int32>> vecs;
+    ASSERT_THROW(item.readBatch(vecs, {{Range(0, 2), Range(0, 2)}}), HdfException);
+    std::vector<int32> vec;
+    ASSERT_THROW(HdfArrayView<int32>(item).read(vec), HdfException);
+    // a read into a buffer of the caller only charges the scratch buffer of the reordering
+    int32 buffer[9];
+    ASSERT_NO_THROW(HdfArrayView<int32>(item).read(buffer, 9));
+    ASSERT_THROW(HdfArrayView<int32>(item).transpose().read(buffer, 9), HdfException);
+    HdfMemoryStats stats = file.getMemoryBudget().getStats();
+    ASSERT_EQ(stats.inUse, 0);
+    ASSERT_EQ(stats.rejected, 3);
+    file.getMemoryBudget().setLimit(0);
+}
+
+TEST(HdfMemoryBudgetTest, ChargesWithinTheLimit) {
+    HdfMemoryBudget budget(100);
+    {
+        HdfMemoryBudget::Charge first = HdfMemoryBudget::charge(&budget, 60);
+        ASSERT_TRUE((bool)first);
+        ASSERT_FALSE((bool)HdfMemoryBudget::charge(&budget, 41));
+        ASSERT_EQ(HdfMemoryBudget::getAvailable(&budget), 40);
+        HdfMemoryBudget::Charge second = HdfMemoryBudget::charge(&budget, 40);
+        ASSERT_TRUE((bool)second);
+    }
+    HdfMemoryStats stats = budget.getStats();
+    ASSERT_EQ(stats.inUse, 0);
+    ASSERT_EQ(stats.peak, 100);
+    ASSERT_EQ(stats.rejected, 1);
+    budget.resetStats();
+    ASSERT_EQ(budget.getStats().peak, 0);
+}
+
+TEST_F(HdfFileTest, ReadIntoAlignedBuffer) {
+    HdfItem item = file.get("Data");
+    HdfItem::Buffer<int32> vec;
+    item.read(vec);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(vec.data()) % 64, 0);
+    ASSERT_EQ(std::vector<int32>(vec.begin(), vec.end()), std::vector<int32>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(HdfAllocatorTest, AlignsLargeBuffers) {
+    std::vector<uint8, HdfAllocator<uint8, 4096, ALLOCATION_HUGE_PAGES | ALLOCATION_FIRST_TOUCH>> large(
+    3 * LARGE_BUFFER_SIZE + 1, 7);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(large.data()) % 4096, 0);
+    ASSERT_EQ(large.front(), 7);
+    ASSERT_EQ(large.back(), 7);
+    std::vector<float64, HdfAllocator<float64, 32, 0>> small(3, 1.5);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(small.data()) % 32, 0);
+    ASSERT_EQ(small, (std::vector<float64, HdfAllocator<float64, 32, 0>>(3, 1.5)));
+}
+
+TEST_F(HdfFileTest, Pyramid) {
+    HdfItem item = file.get("Data");
+    HdfPyramidOptions options;
+    options.aggregation = AGGREGATE_MAX;
+    options.minSize = 1;
+    HdfPyramid pyramid(item, options);
+    ASSERT_EQ(pyramid.getLevelCount(), 2);
+    ASSERT_EQ(pyramid.getLevelDims(0), std::vector<int32>({2, 2}));
+    ASSERT_EQ(pyramid.getLevelDims(1), std::vector<int32>({1, 1}));
+    std::vector<float64> vec;
+    pyramid.read(vec, 0);
+    ASSERT_EQ(vec, std::vector<float64>({5, 6, 8, 9}));
+    ASSERT_EQ(pyramid.readWindow(vec, {Range(2, 1), Range(0, 3)}, 2.5).first, 0);
+    ASSERT_EQ(vec, std::vector<float64>({8, 9}));
+    ASSERT_EQ(pyramid.getNearestLevel(100), 1);
+    ASSERT_THROW(pyramid.read(vec, 2), HdfException);
+
+    std::string path = testing::TempDir() + "hdf4cpp_pyramid_test.pyramid";
+    pyramid.save(path);
+    HdfPyramid loaded(path);
+    std::remove(path.c_str());
+    loaded.read(vec, 1);
+    ASSERT_EQ(vec, std::vector<float64>({9}));
+    ASSERT_THROW(HdfPyramid(TEST_DATA_PATH "small_test.hdf"), HdfException);
+}
+
+TEST_F(HdfFileTest, PyramidCache) {
+    HdfItem item = file.get("Data");
+    HdfPyramidOptions options;
+    options.aggregation = AGGREGATE_MAX;
+    options.minSize = 1;
+    std::string directory = testing::TempDir();
+    std::string source = directory + "hdf4cpp_pyramid_source.hdf";
+    {
+        std::ifstream in(TEST_DATA_PATH "small_test.hdf", std::ios::binary);
+        std::ofstream out(source, std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    }
+    auto setModificationTime = [&source](time_t time) {
+        struct utimbuf times;
+        times.actime = time;
+        times.modtime = time;
+        ASSERT_EQ(utime(source.c_str(), &times), 0);
+    };
+    std::vector<float64> vec;
+
+    setModificationTime(1000000000);
+    std::string path = HdfPyramid::getCachePath(item, source, directory, options);
+    std::remove(path.c_str());
+    HdfPyramid::open(item, source, directory, options).read(vec, 1);
+    ASSERT_EQ(vec, std::vector<float64>({9}));
+    ASSERT_TRUE(std::ifstream(path, std::ios::binary).good());
+
+    // the cache file is loaded, not rebuilt: the value changed in it is read back
+    {
+        std::fstream cache(path, std::ios::binary | std::ios::in | std::ios::out);
+        float64 changed = 42;
+        cache.seekp(-(std::streamoff)sizeof(changed), std::ios::end);
+        cache.write(reinterpret_cast<const char *>(&changed), sizeof(changed));
+    }
+    HdfPyramid::open(item, source, directory, options).read(vec, 1);
+    ASSERT_EQ(vec, std::vector<float64>({42}));
+
+    // a modified source file has an other cache key, so the pyramid is rebuilt
+    setModificationTime(1000000100);
+    std::string modifiedPath = HdfPyramid::getCachePath(item, source, directory, options);
+    ASSERT_NE(modifiedPath, path);
+    std::remove(modifiedPath.c_str());
+    HdfPyramid::open(item, source, directory, options).read(vec, 1);
+    ASSERT_EQ(vec, std::vector<float64>({9}));
+
+    // a damaged cache file is rebuilt and replaced
+    std::ofstream(modifiedPath, std::ios::binary | std::ios::trunc) << "damaged";
+    HdfPyramid::open(item, source, directory, options).read(vec, 1);
+    ASSERT_EQ(vec, std::vector<float64>({9}));
+    HdfPyramid(modifiedPath).read(vec, 0);
+    ASSERT_EQ(vec, std::vector<float64>({5, 6, 8, 9}));
+
+    std::remove(path.c_str());
+    std::remove(modifiedPath.c_str());
+    std::remove(source.c_str());
+}
+
+TEST_F(HdfFileTest, StorageLayout) {
+    HdfStorageLayout layout = file.get("Data").getStorageLayout();
+    ASSERT_FALSE(layout.chunked);
+    ASSERT_FALSE(layout.isCompressed());
+    ASSERT_EQ(layout.logicalSize, 9 * sizeof(int32));
+    ASSERT_EQ(layout.storedSize, layout.logicalSize);
+    ASSERT_EQ(layout.getCompressionRatio(), 1.0);
+
+    HdfItem vdata = file.get("Vdata");
+    HdfRecordLayout records = vdata.getRecordLayout();
+    ASSERT_EQ(records.recordCount, vdata.getRecordCount());
+    ASSERT_EQ(records.storedSize, (std::uint64_t)records.recordCount * records.recordSize);
+    auto age = std::find_if(records.fields.begin(), records.fields.end(), [](const HdfRecordField &field) {
+        return field.name == "age";
+    });
+    ASSERT_NE(age, records.fields.end());
+    ASSERT_EQ(age->dataType, DFNT_INT32);
+    ASSERT_EQ(age->order, 1);
+    ASSERT_THROW(vdata.getStorageLayout(), HdfException);
+}
+
+TEST_F(HdfFileTest, Checksum) {
+    HdfItem data = file.get("Data");
+    HdfChecksummer checksummer;
+    HdfChecksum checksum = checksummer.checksum(data);
+    ASSERT_EQ(checksum.path, "/Data");
+    ASSERT_EQ(checksum.size, 9 * sizeof(int32));
+
+    // the digest does not depend on the band size
+    HdfChecksumOptions options;
+    options.bandSize = 1;
+    HdfChecksummer streaming(options);
+    ASSERT_EQ(streaming.checksum(data).digest, checksum.digest);
+    HdfItem vdata = file.get("Vdata");
+    ASSERT_EQ(streaming.checksum(vdata).digest, checksummer.checksum(vdata).digest);
+
+    HdfChecksumManifest manifest = checksummer.checksumFile(file);
+    auto found = std::find_if(manifest.items.begin(), manifest.items.end(), [](const HdfChecksum &item) {
+        return item.path == "/Data";
+    });
+    ASSERT_NE(found, manifest.items.end());
+    ASSERT_EQ(found->digest, checksum.digest);
+    ASSERT_EQ(checksummer.checksumFile(file).digest, manifest.digest);
+}
+
+TEST(HdfHash64Test, MatchesXxHash64) {
+    ASSERT_EQ(HdfHash64().digest(), 0xef46db3751d8e999ULL);
+    HdfHash64 abc;
+    abc.update("abc", 3);
+    ASSERT_EQ(abc.digest(), 0x44bc2cf5ad770999ULL);
+    std::string text = "Nobody inspects the spammish repetition";
+    HdfHash64 hash;
+    hash.update(text.data(), 5);
+    hash.update(text.data() + 5, text.size() - 5);
+    ASSERT_EQ(hash.digest(), 0xfbcea83c8a378bf1ULL);
+}
+
+TEST_F(HdfFileTest, Diff) {
+    HdfDiffer differ;
+    HdfFile same(TEST_DATA_PATH "small_test.hdf");
+    HdfFileDiff fileDiff = differ.diff(file, same);
+    ASSERT_TRUE(fileDiff.equal());
+    ASSERT_GT(fileDiff.compared, 0);
+
+    HdfItem data = file.get("Data");
+    HdfItem other = file.get("DataWithAttributes");
+    HdfItemDiff itemDiff = differ.diff(data, other);
+    ASSERT_FALSE(itemDiff.equal());
+    ASSERT_EQ(itemDiff.compared, 0);
+    HdfItem sameData = same.get("Data");
+    itemDiff = differ.diff(data, sameData);
+    ASSERT_TRUE(itemDiff.equal());
+    ASSERT_EQ(itemDiff.compared, 9);
+}
+
+/// Writes two files with the 2x3 float32 SData "Values" through the HDF4 API,
+/// the second one differs by 0.05, 0.5 and 0.2 at the indices 1, 3 and 5
+class HdfDiffTest : public ::testing::Test {
+  protected:
+    static std::string getPath(int file) {
+        return testing::TempDir() + "hdf4cpp_diff_test" + std::to_string(file) + ".hdf";
+    }
+
+    static void writeValues(const std::string &path, std::vector<float32> values) {
+        int32 sId = SDstart(path.c_str(), DFACC_CREATE);
+        ASSERT_NE(sId, FAIL);
+        int32 dims[2] = {2, 3};
+        int32 start[2] = {0, 0};
+        int32 id = SDcreate(sId, "Values", DFNT_FLOAT32, 2, dims);
+        ASSERT_NE(id, FAIL);
+        ASSERT_NE(SDwritedata(id, start, nullptr, dims, values.data()), FAIL);
+        SDendaccess(id);
+        SDend(sId);
+    }
+
+    static void SetUpTestCase() {
+        writeValues(getPath(1), {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+        writeValues(getPath(2), {1.0f, 2.05f, 3.0f, 4.5f, 5.0f, 6.2f});
+    }
+
+    static void TearDownTestCase() {
+        std::remove(getPath(1).c_str());
+        std::remove(getPath(2).c_str());
+    }
+
+    HdfItemDiff diff(const HdfDiffOptions &options) {
+        HdfItem first = firstFile.get("Values");
+        HdfItem second = secondFile.get("Values");
+        return HdfDiffer(options).diff(first, second);
+    }
+
+    HdfFile firstFile{getPath(1)};
+    HdfFile secondFile{getPath(2)};
+};
+
+TEST_F(HdfDiffTest, Exact) {
+    HdfItemDiff result = diff(HdfDiffOptions());
+    ASSERT_EQ(result.compared, 6);
+    ASSERT_EQ(result.differing, 3);
+    ASSERT_EQ(result.firstDifference, 1);
+    ASSERT_NEAR(result.maxAbsDiff, 0.5, 1e-6);
+}
+
+TEST_F(HdfDiffTest, Tolerance) {
+    HdfDiffOptions options;
+    options.tolerance = 0.1;
+    HdfItemDiff result = diff(options);
+    ASSERT_EQ(result.differing, 2);
+    ASSERT_EQ(result.firstDifference, 3);
+    ASSERT_NEAR(result.maxAbsDiff, 0.5, 1e-6);
+
+    // the differences within the tolerance still count for the largest difference
+    options.tolerance = 1.0;
+    result = diff(options);
+    ASSERT_TRUE(result.equal());
+    ASSERT_NEAR(result.maxAbsDiff, 0.5, 1e-6);
+}
+
+TEST_F(HdfDiffTest, RelativeTolerance) {
+    HdfDiffOptions options;
+    options.relativeTolerance = 0.05;
+    HdfItemDiff result = diff(options);
+    ASSERT_EQ(result.differing, 1);
+    ASSERT_EQ(result.firstDifference, 3);
+    ASSERT_NEAR(result.maxAbsDiff, 0.5, 1e-6);
+}
+
+TEST_F(HdfDiffTest, MaxAbsDiffOfEveryBand) {
+    HdfDiffOptions options;
+    options.tolerance = 1.0;
+    // a band is a row, the largest difference is in the second one
+    options.bandSize = 3 * sizeof(float32);
+    HdfItemDiff result = diff(options);
+    ASSERT_EQ(result.compared, 6);
+    ASSERT_EQ(result.differing, 0);
+    ASSERT_NEAR(result.maxAbsDiff, 0.5, 1e-6);
+}
+
+TEST_F(HdfDiffTest, StopAtFirst) {
+    HdfDiffOptions options;
+    options.stopAtFirst = true;
+    options.bandSize = 3 * sizeof(float32);
+    HdfItemDiff result = diff(options);
+    ASSERT_EQ(result.compared, 3);
+    ASSERT_EQ(result.differing, 1);
+    ASSERT_EQ(result.firstDifference, 1);
+    ASSERT_NEAR(result.maxAbsDiff, 0.05, 1e-6);
+}
+
+/// Writes a small file with GR images through the HDF4 API:
+/// the lone image "Image" has 3 rows and 4 columns of 2 int16 components with the value
+/// row * 100 + column * 10 + component, a palette of 256 RGB entries and the attribute "unit",
+/// the 2x2 uint8 image "Grouped" is a member of the VGroup "Images"
+class HdfImageTest : public ::testing::Test {
+  protected:
+    static std::string getPath() {
+        return testing::TempDir() + "hdf4cpp_image_test.hdf";
+    }
+
+    static void SetUpTestCase() {
+        int32 fileId = Hopen(getPath().c_str(), DFACC_CREATE, 0);
+        ASSERT_NE(fileId, FAIL);
+        Vstart(fileId);
+        int32 grId = GRstart(fileId);
+        ASSERT_NE(grId, FAIL);
+
+        int32 start[2] = {0, 0};
+        int32 dims[2] = {4, 3};
+        std::vector<int16> pixels;
+        for (int16 row = 0; row < 3; ++row) {
+            for (int16 column = 0; column < 4; ++column) {
+                pixels.push_back(row * 100 + column * 10);
+                pixels.push_back(row * 100 + column * 10 + 1);
+            }
+        }
+        int32 image = GRcreate(grId, "Image", 2, DFNT_INT16, MFGR_INTERLACE_PIXEL, dims);
+        ASSERT_NE(image, FAIL);
+        ASSERT_NE(GRwriteimage(image, start, nullptr, dims, pixels.data()), FAIL);
+        int32 unit = 7;
+        ASSERT_NE(GRsetattr(image, "unit", DFNT_INT32, 1, &unit), FAIL);
+        std::vector<uint8> palette(256 * 3);
+        for (size_t i = 0; i < palette.size(); ++i) {
+            palette[i] = (uint8)i;
+        }
+        ASSERT_NE(GRwritelut(GRgetlutid(image, 0), 3, DFNT_UINT8, MFGR_INTERLACE_PIXEL, 256, palette.data()), FAIL);
+        GRendaccess(image);
+
+        int32 groupedDims[2] = {2, 2};
+        uint8 grouped[4] = {1, 2, 3, 4};
+        image = GRcreate(grId, "Grouped", 1, DFNT_UINT8, MFGR_INTERLACE_PIXEL, groupedDims);
+        ASSERT_NE(image, FAIL);
+        ASSERT_NE(GRwriteimage(image, start, nullptr, groupedDims, grouped), FAIL);
+        int32 group = Vattach(fileId, -1, "w");
+        ASSERT_NE(group, FAIL);
+        Vsetname(group, "Images");
+        ASSERT_NE(Vaddtagref(group, DFTAG_RIG, GRidtoref(image)), FAIL);
+        Vdetach(group);
+        GRendaccess(image);
+
+        GRend(grId);
+        Vend(fileId);
+        Hclose(fileId);
+    }
+
+    static void TearDownTestCase() {
+        std::remove(getPath().c_str());
+    }
+
+    HdfFile file{getPath()};
+};
+
+TEST_F(HdfImageTest, ImageInfo) {
+    HdfItem item = file.get("Image");
+    ASSERT_EQ(item.getType(), GRIMAGE);
+    ASSERT_EQ(item.getName(), "Image");
+    ASSERT_EQ(item.getDims(), std::vector<int32>({3, 4}));
+    ASSERT_EQ(item.getComponentCount(), 2);
+    ASSERT_EQ(item.getDataType(), DFNT_INT16);
+}
+
+TEST_F(HdfImageTest, ReadWholeImage) {
+    HdfItem item = file.get("Image");
+    std::vector<int16> vec;
+    item.read(vec);
+    ASSERT_EQ(vec.size(), 24);
+    ASSERT_EQ(vec[0], 0);
+    ASSERT_EQ(vec[3], 11);
+    ASSERT_EQ(vec[23], 231);
+    std::vector<float32> mismatch;
+    ASSERT_THROW(item.read(mismatch), HdfException);
+}
+
+TEST_F(HdfImageTest, ReadImageWindowInEveryInterlace) {
+    HdfItem item = file.get("Image");
+    std::vector<Range> window({Range(1, 2), Range(0, 2, 2)});
+    std::vector<int16> vec;
+    item.readImage(vec, window);
+    ASSERT_EQ(vec, std::vector<int16>({100, 101, 120, 121, 200, 201, 220, 221}));
+    item.readImage(vec, window, INTERLACE_LINE);
+    ASSERT_EQ(vec, std::vector<int16>({100, 120, 101, 121, 200, 220, 201, 221}));
+    item.readImage(vec, window, INTERLACE_COMPONENT);
+    ASSERT_EQ(vec, std::vector<int16>({100, 120, 200, 220, 101, 121, 201, 221}));
+    item.readImage(vec, {Range(2, 1)});
+    ASSERT_EQ(vec, std::vector<int16>({200, 201, 210, 211, 220, 221, 230, 231}));
+    ASSERT_THROW(item.readImage(vec, {Range(0, 3, 2)}), HdfException);
+}
+
+TEST_F(HdfImageTest, ReadImageIntoBuffer) {
+    HdfItem item = file.get("Image");
+    int16 buffer[8];
+    item.readImage(buffer, 8, {Range(0, 2), Range(3, 1)}, INTERLACE_COMPONENT);
+    ASSERT_EQ(std::vector<int16>(buffer, buffer + 4), std::vector<int16>({30, 130, 31, 131}));
+    ASSERT_THROW(item.readImage(buffer, 7, {Range(1, 2), Range(0, 2, 2)}), HdfException);
+}
+
+TEST_F(HdfImageTest, ReadPalette) {
+    HdfItem item = file.get("Image");
+    ASSERT_TRUE(item.hasPalette());
+    ASSERT_EQ(item.getPaletteDims(), std::vector<int32>({256, 3}));
+    std::vector<uint8> palette;
+    item.readPalette(palette);
+    ASSERT_EQ(palette.size(), 768);
+    ASSERT_EQ(palette[5], 5);
+    ASSERT_EQ(palette[767], 255);
+
+    HdfItem grouped = file.get("Grouped");
+    ASSERT_FALSE(grouped.hasPalette());
+    ASSERT_EQ(grouped.getPaletteDims(), std::vector<int32>({0, 0}));
+    ASSERT_THROW(grouped.readPalette(palette), HdfException);
+}
+
+TEST_F(HdfImageTest, ImageAttributes) {
+    HdfItem item = file.get("Image");
+    ASSERT_EQ(item.getAttributeNames(), std::vector<std::string>({"unit"}));
+    std::vector<int32> vec;
+    item.getAttribute("unit").get(vec);
+    ASSERT_EQ(vec, std::vector<int32>({7}));
+    ASSERT_THROW(item.getAttribute("missing"), HdfException);
+    ASSERT_FALSE(item.tryGetAttribute("missing"));
+}
+
+TEST_F(HdfImageTest, LoneAndGroupedImages) {
+    std::vector<std::string> names;
+    for (auto item : file) {
+        names.push_back(item.getName());
+    }
+    ASSERT_NE(std::find(names.begin(), names.end(), "Image"), names.end());
+    ASSERT_NE(std::find(names.begin(), names.end(), "Images"), names.end());
+    ASSERT_EQ(std::find(names.begin(), names.end(), "Grouped"), names.end());
+
+    size_t images = 0;
+    for (const auto &ref : file.getRefs()) {
+        if (ref.getTag() == DFTAG_RIG) {
+            ASSERT_EQ(ref.getType(), GRIMAGE);
+            ASSERT_EQ(ref.get().getName(), "Image");
+            ++images;
+        }
+    }
+    ASSERT_EQ(images, 1);
+
+    HdfItem group = file.get("Images");
+    std::vector<uint8> vec;
+    size_t members = 0;
+    for (auto member : group) {
+        ASSERT_EQ(member.getType(), GRIMAGE);
+        ASSERT_EQ(member.getName(), "Grouped");
+        member.read(vec);
+        ASSERT_EQ(vec, std::vector<uint8>({1, 2, 3, 4}));
+        ++members;
+    }
+    ASSERT_EQ(members, 1);
+}
+
+class HdfHierarchyCycleTest : public ::testing::Test {
+  protected:
+    static std::string getPath() {
+        return testing::TempDir() + "hdf4cpp_hierarchy_cycle_test.hdf";
+    }
+
+    static void SetUpTestCase() {
+        // "Inner" is listed first and is a member of "Second", "First" and "Second" are members of each other,
+        // so no VGroup is lone
+        int32 fileId = Hopen(getPath().c_str(), DFACC_CREATE, 0);
+        ASSERT_NE(fileId, FAIL);
+        Vstart(fileId);
+        int32 inner = Vattach(fileId, -1, "w");
+        int32 first = Vattach(fileId, -1, "w");
+        int32 second = Vattach(fileId, -1, "w");
+        ASSERT_NE(inner, FAIL);
+        ASSERT_NE(first, FAIL);
+        ASSERT_NE(second, FAIL);
+        Vsetname(inner, "Inner");
+        Vsetname(first, "First");
+        Vsetname(second, "Second");
+        ASSERT_NE(Vaddtagref(first, DFTAG_VG, VQueryref(second)), FAIL);
+        ASSERT_NE(Vaddtagref(second, DFTAG_VG, VQueryref(first)), FAIL);
+        ASSERT_NE(Vaddtagref(second, DFTAG_VG, VQueryref(inner)), FAIL);
+        Vdetach(inner);
+        Vdetach(first);
+        Vdetach(second);
+        Vend(fileId);
+        Hclose(fileId);
+    }
+
+    static void TearDownTestCase() {
+        std::remove(getPath().c_str());
+    }
+
+    HdfFile file{getPath()};
+};
+
+TEST_F(HdfHierarchyCycleTest, CycleWithoutLoneEntry) {
+    ASSERT_TRUE(file.getRefs().empty());
+    HdfHierarchy hierarchy(file);
+    ASSERT_EQ(hierarchy.size(), 3);
+    ASSERT_TRUE(hierarchy.hasCycles());
+    ASSERT_EQ(hierarchy.getCycleEdges().size(), 1);
+    ASSERT_EQ(hierarchy.getRoots().size(), 1);
+    ASSERT_EQ(hierarchy.getNode(hierarchy.getRoots().front()).name, "First");
+
+    std::vector<std::string> visited;
+    hierarchy.visit([&](const HdfNode &node) {
+        visited.push_back(node.name);
+        return true;
+    });
+    ASSERT_EQ(visited, std::vector<std::string>({"First", "Second", "Inner"}));
+}
+
+class HdfChecksumFieldsTest : public ::testing::Test {
+  protected:
+    static std::string getPath(int file) {
+        return testing::TempDir() + "hdf4cpp_checksum_test" + std::to_string(file) + ".hdf";
+    }
+
+    /// Writes the same 2 records of 2 int32 values, as one field of order 2 or as two fields
+    static void writeRecords(const std::string &path, bool split) {
+        int32 fileId = Hopen(path.c_str(), DFACC_CREATE, 0);
+        ASSERT_NE(fileId, FAIL);
+        Vstart(fileId);
+        int32 id = VSattach(fileId, -1, "w");
+        ASSERT_NE(id, FAIL);
+        VSsetname(id, "Records");
+        if (split) {
+            ASSERT_NE(VSfdefine(id, "first", DFNT_INT32, 1), FAIL);
+            ASSERT_NE(VSfdefine(id, "second", DFNT_INT32, 1), FAIL);
+            ASSERT_NE(VSsetfields(id, "first,second"), FAIL);
+        } else {
+            ASSERT_NE(VSfdefine(id, "values", DFNT_INT32, 2), FAIL);
+            ASSERT_NE(VSsetfields(id, "values"), FAIL);
+        }
+        int32 records[4] = {1, 2, 3, 4};
+        ASSERT_EQ(VSwrite(id, reinterpret_cast<uint8 *>(records), 2, FULL_INTERLACE), 2);
+        VSdetach(id);
+        Vend(fileId);
+        Hclose(fileId);
+    }
+
+    static void SetUpTestCase() {
+        writeRecords(getPath(1), false);
+        writeRecords(getPath(2), true);
+    }
+
+    static void TearDownTestCase() {
+        std::remove(getPath(1).c_str());
+        std::remove(getPath(2).c_str());
+    }
+};
+
+TEST_F(HdfChecksumFieldsTest, FieldsAreHashed) {
+    HdfFile first(getPath(1));
+    HdfFile second(getPath(2));
+    HdfItem firstRecords = first.get("Records");
+    HdfItem secondRecords = second.get("Records");
+    ASSERT_EQ(firstRecords.getRecordLayout().fields.size(), 1);
+    ASSERT_EQ(secondRecords.getRecordLayout().fields.size(), 2);
+
+    // the same bytes in other fields have an other digest
+    HdfChecksummer checksummer;
+    HdfChecksum firstChecksum = checksummer.checksum(firstRecords);
+    HdfChecksum secondChecksum = checksummer.checksum(secondRecords);
+    ASSERT_EQ(firstChecksum.size, 4 * sizeof(int32));
+    ASSERT_EQ(secondChecksum.size, firstChecksum.size);
+    ASSERT_NE(firstChecksum.digest, secondChecksum.digest);
+}
+
+TEST_F(HdfChecksumFieldsTest, FieldsAreDiffed) {
+    HdfFile first(getPath(1));
+    HdfFile second(getPath(2));
+    HdfItem firstRecords = first.get("Records");
+    HdfItem secondRecords = second.get("Records");
+
+    // the same bytes in other fields differ
+    HdfItemDiff result = HdfDiffer().diff(firstRecords, secondRecords);
+    std::vector<std::string> expected = {"field count 1 != 2", "field 0 name values != first", "field 0 order 2 != 1"};
+    ASSERT_EQ(result.differences, expected);
+    ASSERT_EQ(result.compared, 0);
+}
+
+class HdfUnlimitedDimensionTest : public ::testing::Test {
+  protected:
+    static std::string getPath() {
+        return testing::TempDir() + "hdf4cpp_unlimited_test.hdf";
+    }
+
+    static void writeRecords(int32 sId, const char *name, std::vector<int32> values) {
+        int32 dims[1] = {SD_UNLIMITED};
+        int32 start[1] = {0};
+        int32 edges[1] = {(int32)values.size()};
+        int32 id = SDcreate(sId, name, DFNT_INT32, 1, dims);
+        ASSERT_NE(id, FAIL);
+        ASSERT_NE(SDsetdimname(SDgetdimid(id, 0), "time"), FAIL);
+        ASSERT_NE(SDwritedata(id, start, nullptr, edges, values.data()), FAIL);
+        SDendaccess(id);
+    }
+
+    static void SetUpTestCase() {
+        // "Short" and "Long" share the unlimited dimension "time" with 2 and 4 records, its scale has 4 values
+        int32 sId = SDstart(getPath().c_str(), DFACC_CREATE);
+        ASSERT_NE(sId, FAIL);
+        writeRecords(sId, "Short", {1, 2});
+        writeRecords(sId, "Long", {1, 2, 3, 4});
+        int32 id = SDselect(sId, SDnametoindex(sId, "Long"));
+        ASSERT_NE(id, FAIL);
+        float64 scale[4] = {10.0, 20.0, 30.0, 40.0};
+        ASSERT_NE(SDsetdimscale(SDgetdimid(id, 0), 4, DFNT_FLOAT64, scale), FAIL);
+        SDendaccess(id);
+        SDend(sId);
+    }
+
+    static void TearDownTestCase() {
+        std::remove(getPath().c_str());
+    }
+
+    HdfFile file{getPath()};
+};
+
+TEST_F(HdfUnlimitedDimensionTest, ScaleHasTheSizeOfTheDataset) {
+    HdfItem shortItem = file.get("Short");
+    HdfItem longItem = file.get("Long");
+    HdfDimension shortTime = shortItem.getDimension(0);
+    HdfDimension longTime = longItem.getDimension(0);
+    ASSERT_TRUE(shortTime.isUnlimited());
+    ASSERT_EQ(shortTime.getSize(), 2);
+    ASSERT_EQ(longTime.getSize(), 4);
+
+    // the shorter dataset loads first, the longer one still gets every value
+    std::vector<float64> scale;
+    shortTime.getScale(scale);
+    ASSERT_EQ(scale, std::vector<float64>({10.0, 20.0}));
+    longTime.getScale(scale);
+    ASSERT_EQ(scale, std::vector<float64>({10.0, 20.0, 30.0, 40.0}));
+
+    // the coordinate ranges stay within the extent of each dataset
+    ASSERT_EQ(shortItem.getCoordinateRanges({HdfInterval(25.0, 45.0)})[0].quantity, 0);
+    Range range = longItem.getCoordinateRanges({HdfInterval(25.0, 45.0)})[0];
+    ASSERT_EQ(range.begin, 2);
+    ASSERT_EQ(range.quantity, 2);
+}
+
+class HdfDuplicateNameTest : public ::testing::Test {
+  protected:
+    static std::string getPath() {
+        return testing::TempDir() + "hdf4cpp_duplicate_test.hdf";
+    }
+
+    static void writeValues(int32 sId, std::vector<float32> values) {
+        int32 dims[2] = {2, 2};
+        int32 start[2] = {0, 0};
+        int32 id = SDcreate(sId, "Values", DFNT_FLOAT32, 2, dims);
+        ASSERT_NE(id, FAIL);
+        ASSERT_NE(SDwritedata(id, start, nullptr, dims, values.data()), FAIL);
+        SDendaccess(id);
+    }
+
+    static void SetUpTestCase() {
+        // two datasets with the same name and shape
+        int32 sId = SDstart(getPath().c_str(), DFACC_CREATE);
+        ASSERT_NE(sId, FAIL);
+        writeValues(sId, {1.0f, 2.0f, 3.0f, 4.0f});
+        writeValues(sId, {8.0f, 7.0f, 6.0f, 5.0f});
+        SDend(sId);
+    }
+
+    static void TearDownTestCase() {
+        std::remove(getPath().c_str());
+    }
+
+    HdfFile file{getPath()};
+};
+
+TEST_F(HdfDuplicateNameTest, PyramidCachePerDataset) {
+    std::vector<HdfItem> items = file.getAll("Values");
+    ASSERT_EQ(items.size(), 2);
+    HdfPyramidOptions options;
+    options.aggregation = AGGREGATE_MAX;
+    options.minSize = 1;
+    std::string directory = testing::TempDir();
+    std::string first = HdfPyramid::getCachePath(items[0], getPath(), directory, options);
+    std::string second = HdfPyramid::getCachePath(items[1], getPath(), directory, options);
+    ASSERT_NE(first, second);
+
+    std::vector<float64> vec;
+    HdfPyramid::open(items[0], getPath(), directory, options).read(vec, 0);
+    ASSERT_EQ(vec, std::vector<float64>({4}));
+    HdfPyramid::open(items[1], getPath(), directory, options).read(vec, 0);
+    ASSERT_EQ(vec, std::vector<float64>({8}));
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
+
+TEST_F(HdfDuplicateNameTest, GeolocationSidecarPerDataset) {
+    std::vector<HdfItem> items = file.getAll("Values");
+    ASSERT_EQ(items.size(), 2);
+    std::string sidecar = testing::TempDir() + "hdf4cpp_duplicate_test.idx";
+    std::remove(sidecar.c_str());
+
+    // the sidecar of the first dataset is not served for the second one
+    HdfPixel pixel = HdfGeolocationIndex::open(items[0], items[0], getPath(), sidecar).nearest(HdfGeoPoint{1.0, 1.0});
+    ASSERT_EQ(pixel.row * 2 + pixel.column, 0);
+    pixel = HdfGeolocationIndex::open(items[1], items[1], getPath(), sidecar).nearest(HdfGeoPoint{1.0, 1.0});
+    ASSERT_EQ(pixel.row * 2 + pixel.column, 3);
+    std::remove(sidecar.c_str());
+}
+
+TEST(HdfFileLocalTest, SharedUntilTheFileIsClosed) {
+    HdfFileLocal<int> locals;
+    int created = 0;
+    auto create = [&]() { return std::make_shared<int>(++created); };
+    std::shared_ptr<int> file = std::make_shared<int>(0);
+    ASSERT_EQ(*locals.get(1, file, create), 1);
+    ASSERT_EQ(*locals.get(1, file, create), 1);
+    file.reset();
+    std::shared_ptr<int> reopened = std::make_shared<int>(0);
+    ASSERT_EQ(*locals.get(1, reopened, create), 2);
+}
@@ -0,0 +1,109 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+// built with a MAX_READ_SIZE of 64 bytes (see CMakeLists.txt), so the reads of the 3x4x5 int32 dataset
+// (80 bytes along the first dimension) are split into more SDreaddata calls
+
+#include <gtest/gtest.h>
+#include <hdf4cpp/hdf.h>
+
+#include <cstdio>
+
+using namespace hdf4cpp;
+
+static_assert(MAX_READ_SIZE == 64, "the tests need a MAX_READ_SIZE of 64 bytes");
+
+class HdfSmallReadTest : public ::testing::Test {
+  protected:
+    static std::string getPath() {
+        return testing::TempDir() + "hdf4cpp_small_read_test.hdf";
+    }
+
+    static void SetUpTestCase() {
+        std::vector<int32> values;
+        for (int32 a = 0; a < 3; ++a) {
+            for (int32 b = 0; b < 4; ++b) {
+                for (int32 c = 0; c < 5; ++c) {
+                    values.push_back(a * 100 + b * 10 + c);
+                }
+            }
+        }
+        int32 sId = SDstart(getPath().c_str(), DFACC_CREATE);
+        ASSERT_NE(sId, FAIL);
+        int32 dims[3] = {3, 4, 5};
+        int32 start[3] = {0, 0, 0};
+        int32 id = SDcreate(sId, "Values", DFNT_INT32, 3, dims);
+        ASSERT_NE(id, FAIL);
+        ASSERT_NE(SDwritedata(id, start, nullptr, dims, values.data()), FAIL);
+        SDendaccess(id);
+        SDend(sId);
+    }
+
+    static void TearDownTestCase() {
+        std::remove(getPath().c_str());
+    }
+
+    /// \returns The values of the ranges in row major order
+    static std::vector<int32> expected(const std::vector<Range> &ranges) {
+        std::vector<int32> values;
+        for (int32 a = 0; a < ranges[0].quantity; ++a) {
+            for (int32 b = 0; b < ranges[1].quantity; ++b) {
+                for (int32 c = 0; c < ranges[2].quantity; ++c) {
+                    values.push_back((ranges[0].begin + a * ranges[0].stride) * 100 +
+                                     (ranges[1].begin + b * ranges[1].stride) * 10 + ranges[2].begin +
+                                     c * ranges[2].stride);
+                }
+            }
+        }
+        return values;
+    }
+
+    HdfFile file{getPath()};
+};
+
+TEST_F(HdfSmallReadTest, SplitAlongFirstDimension) {
+    // 40 bytes for an index of the first dimension, so every index is read by its own call
+    HdfItem item = file.get("Values");
+    std::vector<Range> ranges = {Range(0, 3), Range(0, 2), Range(0, 5)};
+    std::vector<int32> values;
+    item.read(values, ranges);
+    ASSERT_EQ(values, expected(ranges));
+}
+
+TEST_F(HdfSmallReadTest, SplitAlongSecondDimension) {
+    // 80 bytes for an index of the first dimension, so it is split into calls of 3 and 1 rows of 20 bytes
+    HdfItem item = file.get("Values");
+    std::vector<Range> ranges = {Range(0, 3), Range(0, 4), Range(0, 5)};
+    std::vector<int32> values;
+    item.read(values, ranges);
+    ASSERT_EQ(values, expected(ranges));
+    ASSERT_EQ(values.size(), 60);
+
+    std::vector<int32> whole;
+    item.read(whole);
+    ASSERT_EQ(whole, values);
+}
+
+TEST_F(HdfSmallReadTest, SplitStridedRanges) {
+    HdfItem item = file.get("Values");
+    std::vector<Range> ranges = {Range(0, 2, 2), Range(0, 4), Range(1, 2, 3)};
+    std::vector<int32> values;
+    item.read(values, ranges);
+    ASSERT_EQ(values, expected(ranges));
+
+    ranges = {Range(0, 3), Range(1, 2, 2), Range(0, 5)};
+    item.read(values, ranges);
+    ASSERT_EQ(values, expected(ranges));
+}
+
+TEST_F(HdfSmallReadTest, SplitBatch) {
+    // the merged read of the batch is split into the scratch buffer
+    HdfItem item = file.get("Values");
+    std::vector<std::vector<Range>> requests = {{Range(0, 2), Range(0, 4), Range(0, 5)},
+                                                {Range(1, 2), Range(2, 2), Range(1, 3)}};
+    std::vector<std::vector<int32>> values;
+    item.readBatch(values, requests);
+    ASSERT_EQ(values.size(), 2);
+    ASSERT_EQ(values[0], expected(requests[0]));
+    ASSERT_EQ(values[1], expected(requests[1]));
+}
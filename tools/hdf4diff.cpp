@@ -0,0 +1,94 @@
+/// \copyright Copyright (c) Catalysts GmbH
+/// \author Patrik Kovacs, Catalysts GmbH
+
+#include <hdf4cpp/hdf.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace hdf4cpp;
+
+namespace {
+void printUsage() {
+    std::cerr << "Usage: hdf4diff [options] <first.hdf> <second.hdf>\n"
+                 "Compares the structure, the attributes and the data of two HDF4 files.\n"
+                 "  -t, --tolerance <value>   the largest absolute difference of equal SData values\n"
+                 "  -r, --relative <value>    the largest relative difference of equal SData values\n"
+                 "  -q, --quick               stop at the first difference\n"
+                 "  --no-attributes           do not compare the attributes\n"
+                 "  --band-size <bytes>       the size of the bands read at once\n"
+                 "Exit status: 0 if the files are equal, 1 if they differ, 2 on errors\n";
+}
+
+/// Parses a tolerance, which is a finite number not less than 0
+bool parseTolerance(const char *text, float64 &tolerance) {
+    char *end = nullptr;
+    errno = 0;
+    tolerance = std::strtod(text, &end);
+    return end != text && !*end && errno != ERANGE && tolerance >= 0.0 &&
+           tolerance <= std::numeric_limits<float64>::max();
+}
+
+/// Parses a band size, which is a decimal number greater than 0
+bool parseBandSize(const char *text, size_t &bandSize) {
+    char *end = nullptr;
+    errno = 0;
+    // strtoull accepts a sign and negates the value, so only digits are allowed
+    unsigned long long value = text[0] >= '0' && text[0] <= '9' ? std::strtoull(text, &end, 10) : 0;
+    bandSize = (size_t)value;
+    return end && !*end && errno != ERANGE && value > 0 && value <= std::numeric_limits<size_t>::max();
+}
+}
+
+int main(int argc, char **argv) {
+    HdfDiffOptions options;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ((argument == "-t" || argument == "--tolerance") && hasValue) {
+            if (!parseTolerance(argv[++i], options.tolerance)) {
+                printUsage();
+                return 2;
+            }
+        } else if ((argument == "-r" || argument == "--relative") && hasValue) {
+            if (!parseTolerance(argv[++i], options.relativeTolerance)) {
+                printUsage();
+                return 2;
+            }
+        } else if (argument == "-q" || argument == "--quick") {
+            options.stopAtFirst = true;
+        } else if (argument == "--no-attributes") {
+            options.compareAttributes = false;
+        } else if (argument == "--band-size" && hasValue) {
+            if (!parseBandSize(argv[++i], options.bandSize)) {
+                printUsage();
+                return 2;
+            }
+        } else if (!argument.empty() && argument[0] == '-') {
+            printUsage();
+            return 2;
+        } else {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.size() != 2) {
+        printUsage();
+        return 2;
+    }
+
+    try {
+        HdfFile first(paths[0]);
+        HdfFile second(paths[1]);
+        HdfFileDiff diff = HdfDiffer(options).diff(first, second);
+        std::cout << diff.toString();
+        return diff.equal() ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << "hdf4diff: " << e.what() << '\n';
+        return 2;
+    }
+}